@@ -0,0 +1,688 @@
+/*
+		MCheck benchmark program
+
+		Generates models and formulas of increasing size, and reports
+		the time and memory used by each phase of checking them.
+
+		It's built from this file and the program sources, except
+		for main.cpp; for example:
+
+			g++ -O2 -Isrc -o mchbench bench/Bench.cpp \
+				`find src -name '*.cpp' ! -name main.cpp` -lpthread
+
+*/
+#include "globals.h"
+
+#if UNIX
+#include <sys/time.h>
+#endif
+
+extern unsigned char _dfa[];
+
+// ------------------------------------------------------------------
+// Generated workloads
+// ------------------------------------------------------------------
+
+/*	Model in text form, as it would appear in a script
+*/
+class ModelText {
+public:
+	ModelText() {
+		states = 0;
+	}
+
+	/*	Add a state
+			> name						name of state
+			> succ						names of successor states
+			> props						prop. variables true in state
+			> initial					true if it's an initial state
+	*/
+	void addState(int name, const Array<int> &succ, const StringArray &props,
+		bool initial = false)
+	{
+		text << (initial ? ">" : " ") << name;
+		for (int i = 0; i < succ.length(); i++)
+			text << " " << succ[i];
+		if (props.length() == 0)
+			text << " _";
+		for (int i = 0; i < props.length(); i++)
+			text << " " << props[i];
+		text << "\n";
+		states++;
+	}
+
+	// text of model, without the surrounding braces
+	String text;
+	// number of states
+	int states;
+	// prop. variables to use in formulas
+	StringArray vars;
+};
+
+/*	Construct name of prop. variable
+		> prefix					prefix
+		> index						index, or -1 for none
+*/
+static String varName(const char *prefix, int index = -1)
+{
+	String s(prefix);
+	if (index >= 0)
+		s << index;
+	return s;
+}
+
+/*	Raise 3 to a power
+*/
+static int pow3(int n)
+{
+	int r = 1;
+	while (n-- > 0)
+		r *= 3;
+	return r;
+}
+
+/*	Get the state of one process from a state encoded in base 3
+*/
+static int digit(int code, int i)
+{
+	return (code / pow3(i)) % 3;
+}
+
+/*	Change the state of one process in a state encoded in base 3
+*/
+static int setDigit(int code, int i, int value)
+{
+	return code + (value - digit(code, i)) * pow3(i);
+}
+
+/*	Generate N-process mutual exclusion model (generalization of
+		Figure 3.11, test/q1.txt).  Each process is non-critical (n),
+		trying (t) or critical (c); a trying process may enter its
+		critical section if no other process is in it, and either no
+		other process is trying or it's this process's turn.  Leaving
+		the critical section passes the turn to the next process.
+		Every state also has a transition to itself.
+		> n								number of processes
+*/
+static void genMutex(int n, ModelText &m)
+{
+	enum {N, T, C};
+
+	int procStates = pow3(n);
+	int total = procStates * n;
+
+	BitStore visited;
+	Array<int> queue;
+	queue.add(0);
+	visited.set(0);
+
+	for (int q = 0; q < queue.length(); q++) {
+		int code = queue[q];
+		int procs = code % procStates;
+		int turn = code / procStates;
+
+		bool critical = false;
+		int trying = 0;
+		for (int i = 0; i < n; i++) {
+			int d = digit(procs, i);
+			if (d == C) critical = true;
+			if (d == T) trying++;
+		}
+
+		Array<int> succ;
+		succ.add(code);
+
+		for (int i = 0; i < n; i++) {
+			int next = -1;
+			switch (digit(procs, i)) {
+				case N:
+					next = setDigit(procs, i, T) + turn * procStates;
+					break;
+				case T:
+					if (!critical && (turn == i || trying == 1))
+						next = setDigit(procs, i, C) + turn * procStates;
+					break;
+				case C:
+					next = setDigit(procs, i, N) + ((i + 1) % n) * procStates;
+					break;
+			}
+			if (next < 0) continue;
+			succ.add(next);
+			ASSERT(next < total);
+			if (!visited.get(next)) {
+				visited.set(next);
+				queue.add(next);
+			}
+		}
+
+		StringArray props;
+		for (int i = 0; i < n; i++) {
+			static const char *pfx[] = {"n","t","c"};
+			props.add(varName(pfx[digit(procs, i)], i+1));
+		}
+		props.add(varName("r", turn));
+
+		m.addState(code, succ, props, code == 0);
+	}
+
+	for (int i = 0; i < n; i++) {
+		m.vars.add(varName("t", i+1));
+		m.vars.add(varName("c", i+1));
+	}
+}
+
+/*	Generate dining philosophers model.  Each philosopher is
+		thinking, hungry or eating; a hungry philosopher may eat if
+		neither neighbor is eating.
+		> n								number of philosophers
+*/
+static void genPhilosophers(int n, ModelText &m)
+{
+	enum {THINK, HUNGRY, EAT};
+
+	BitStore visited;
+	Array<int> queue;
+	queue.add(0);
+	visited.set(0);
+
+	for (int q = 0; q < queue.length(); q++) {
+		int code = queue[q];
+
+		Array<int> succ;
+		StringArray props;
+		for (int i = 0; i < n; i++) {
+			int next = -1;
+			switch (digit(code, i)) {
+				case THINK:
+					next = setDigit(code, i, HUNGRY);
+					break;
+				case HUNGRY:
+					if (digit(code, (i + n - 1) % n) != EAT
+						&& digit(code, (i + 1) % n) != EAT)
+						next = setDigit(code, i, EAT);
+					props.add(varName("h", i+1));
+					break;
+				case EAT:
+					next = setDigit(code, i, THINK);
+					props.add(varName("e", i+1));
+					break;
+			}
+			if (next < 0) continue;
+			succ.add(next);
+			if (!visited.get(next)) {
+				visited.set(next);
+				queue.add(next);
+			}
+		}
+		m.addState(code, succ, props, code == 0);
+	}
+
+	for (int i = 0; i < n; i++) {
+		m.vars.add(varName("h", i+1));
+		m.vars.add(varName("e", i+1));
+	}
+}
+
+/*	Generate ring of states
+		> n								number of states
+*/
+static void genRing(int n, ModelText &m)
+{
+	for (int i = 0; i < n; i++) {
+		Array<int> succ;
+		succ.add((i + 1) % n);
+		StringArray props;
+		if (i % 2 == 0) props.add("p");
+		if (i % 3 == 0) props.add("q");
+		if (i == 0) props.add("r");
+		m.addState(i, succ, props, i == 0);
+	}
+	m.vars.add("p");
+	m.vars.add("q");
+	m.vars.add("r");
+}
+
+/*	Generate grid of states, with transitions to the right and
+		downward, wrapping around at the edges
+		> n								width (and height) of grid
+*/
+static void genGrid(int n, ModelText &m)
+{
+	for (int y = 0; y < n; y++) {
+		for (int x = 0; x < n; x++) {
+			Array<int> succ;
+			succ.add(y * n + (x + 1) % n);
+			if (n > 1)
+				succ.add(((y + 1) % n) * n + x);
+			StringArray props;
+			if (x == 0) props.add("a");
+			if (y == 0) props.add("b");
+			if (x == y) props.add("c");
+			m.addState(y * n + x, succ, props, x == 0 && y == 0);
+		}
+	}
+	m.vars.add("a");
+	m.vars.add("b");
+	m.vars.add("c");
+}
+
+/*	Generate random graph
+		> n								number of states
+		> degree					number of transitions from each state
+		> nVars						number of prop. variables
+*/
+static void genRandom(int n, int degree, int nVars, ModelText &m)
+{
+	for (int i = 0; i < n; i++) {
+		Array<int> succ;
+		for (int j = 0; j < degree; j++)
+			succ.add(Utils::rand(n));
+		StringArray props;
+		for (int j = 0; j < nVars; j++)
+			if (Utils::rand(2))
+				props.add(varName("v", j));
+		m.addState(i, succ, props, i == 0);
+	}
+	for (int j = 0; j < nVars; j++)
+		m.vars.add(varName("v", j));
+}
+
+/*	Construct chain of until formulas:
+			v0 U (v1 U ( ... U vk-1))
+		> vars						variables to use (repeated if necessary)
+		> k								number of variables in chain
+		> ctl							if true, uses E[ _ U _ ] instead
+*/
+static String untilChain(const StringArray &vars, int k, bool ctl)
+{
+	String s;
+	for (int i = 0; i < k - 1; i++)
+		s << (ctl ? "E[" : "(") << vars[i % vars.length()] << " U ";
+	s << vars[(k - 1) % vars.length()];
+	for (int i = 0; i < k - 1; i++)
+		s << (ctl ? "]" : ")");
+	return s;
+}
+
+/*	Construct conjunction of fairness terms:
+			G F v0 & G F v1 & ... & G F vk-1
+		> vars						variables to use (repeated if necessary)
+		> k								number of terms
+		> ctl							if true, uses AG AF instead
+		> reverse					if true, terms appear in reverse order
+*/
+static String fairness(const StringArray &vars, int k, bool ctl,
+	bool reverse = false)
+{
+	String s;
+	for (int i = 0; i < k; i++) {
+		int j = reverse ? k - 1 - i : i;
+		if (i > 0)
+			s << " & ";
+		s << (ctl ? "AG AF " : "G F ") << vars[j % vars.length()];
+	}
+	return s;
+}
+
+// ------------------------------------------------------------------
+// Measurement
+// ------------------------------------------------------------------
+
+/*	Get elapsed wall time, in seconds
+*/
+static double wallTime()
+{
+#if UNIX
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+#else
+	return 0;
+#endif
+}
+
+// bytes in use by each account (see MemAccount), and in total, when
+// the current phase started
+static long long phaseBase[MemAccount::TOTAL];
+static long long phaseBaseTotal;
+
+/*	Start a phase: reset the memory high-water marks, and record the
+		bytes in use, so the memory the phase itself uses can be
+		reported
+		< wall time phase started
+*/
+static double startPhase()
+{
+	MemAccount::resetPeaks();
+	phaseBaseTotal = 0;
+	for (int i = 0; i < MemAccount::TOTAL; i++) {
+		phaseBase[i] = MemAccount::inUse(i);
+		phaseBaseTotal += phaseBase[i];
+	}
+	return wallTime();
+}
+
+/*	Convert bytes to kilobytes, rounding up
+*/
+static int kb(long long bytes)
+{
+	return (int)((bytes + 1023) / 1024);
+}
+
+/*	Print report of a phase, including the peak memory it used
+		(beyond that in use when it started), in total and for each
+		subsystem that used any
+		> family					name of family
+		> size						size parameter
+		> states					number of states in model
+		> phase						name of phase
+		> start						wall time phase started (from startPhase())
+		> work						number of states processed, or -1 if not
+												meaningful
+*/
+static void report(const char *family, int size, int states,
+	const char *phase, double start, double work)
+{
+	double t = wallTime() - start;
+
+	String f(family);
+	f.pad(8);
+	String p(phase);
+	p.pad(9);
+
+	Cout << f << fmt(size, 6) << fmt(states, 10) << "  " << p
+		<< "  " << fmt(t * 1000, 9, 2);
+	if (work >= 0 && t > 0)
+		Cout << fmt((int)(work / t), 13);
+	else
+		Cout << "            -";
+	Cout << fmt(kb(MemAccount::peakTotal() - phaseBaseTotal), 11) << " ";
+	for (int i = 0; i < MemAccount::TOTAL; i++) {
+		long long bytes = MemAccount::peak(i) - phaseBase[i];
+		if (bytes > 0)
+			Cout << " " << MemAccount::name(i) << ":" << kb(bytes);
+	}
+	Cout << "\n";
+}
+
+// ------------------------------------------------------------------
+// Benchmark
+// ------------------------------------------------------------------
+
+class Bench {
+public:
+	Bench(DFA &dfa, Vars &vars) : vars_(vars), model_(vars_), dfa_(dfa) {
+		k_ = 3;
+		degree_ = 3;
+		states_ = 64;
+	}
+
+	/*	Run benchmark for one size of a family
+			> family					name of family
+			> size						size parameter
+	*/
+	void run(const String &family, int size);
+
+	// number of variables in formulas
+	int k_;
+	// degree of random graphs
+	int degree_;
+	// number of states in models for formula families
+	int states_;
+
+private:
+	/*	Parse a model, and time it
+	*/
+	void parseModel(const char *family, int size, ModelText &m);
+
+	/*	Parse a formula
+	*/
+	void parseFormula(const String &text, Formula &f);
+
+	/*	Check formulas against model, and time it
+			> ctl							CTL formulas
+			> ltl							LTL formulas
+	*/
+	void check(const char *family, int size, const StringArray &ctl,
+		const StringArray &ltl);
+
+	Vars &vars_;
+	Model model_;
+	DFA &dfa_;
+};
+
+void Bench::parseFormula(const String &text, Formula &f)
+{
+	Scanner scan(0,&dfa_);
+	scan.setSkip(TK_WS);
+	StringReader rd(text);
+	scan.includeSource(rd);
+	f.parse(scan);
+}
+
+void Bench::parseModel(const char *family, int size, ModelText &m)
+{
+	String text("{\n");
+	text << m.text << "}\n";
+
+	model_.clear();
+	vars_.clear();
+
+	double start = startPhase();
+	Scanner scan(0,&dfa_);
+	scan.setSkip(TK_WS);
+	StringReader rd(text);
+	scan.includeSource(rd);
+	{
+		MemAccount acc(MemAccount::MODEL);
+		model_.parse(scan);
+	}
+	report(family, size, model_.states(), "parse", start, model_.states());
+}
+
+void Bench::check(const char *family, int size, const StringArray &ctl,
+	const StringArray &ltl)
+{
+	// discard the checkers' output
+	String discard;
+
+	if (ctl.length() > 0) {
+		Array<Formula> forms;
+		for (int i = 0; i < ctl.length(); i++) {
+			Formula f;
+			parseFormula(ctl[i], f);
+			forms.add(f);
+		}
+		double start = startPhase();
+		Utils::pushSink(&discard);
+		for (int i = 0; i < forms.length(); i++) {
+			CTLCheck c;
+			BitStore sat;
+			c.check(vars_, model_, forms[i], &sat);
+		}
+		Utils::popSink();
+		report(family, size, model_.states(), "ctl", start,
+			(double)model_.states() * forms.length());
+	}
+
+	if (ltl.length() > 0) {
+		Array<Formula> forms;
+		for (int i = 0; i < ltl.length(); i++) {
+			Formula f;
+			parseFormula(ltl[i], f);
+			forms.add(f);
+		}
+		double start = startPhase();
+		Utils::pushSink(&discard);
+		LTLCheck c(vars_);
+		for (int i = 0; i < forms.length(); i++)
+			c.check(model_, forms[i]);
+		Utils::popSink();
+		report(family, size, model_.states(), "ltl", start,
+			(double)model_.states() * forms.length());
+	}
+}
+
+void Bench::run(const String &family, int size)
+{
+	const char *fam = family.chars();
+	ModelText m;
+	StringArray ctl, ltl;
+
+	if (family.equals("until") || family.equals("fair")) {
+
+		// formula family: size is number of variables in formula
+
+		genRandom(states_, degree_, size, m);
+		parseModel(fam, size, m);
+
+		bool until = family.equals("until");
+		String f1, f2;
+		if (until) {
+			ctl.add(untilChain(m.vars, size, true));
+			f1 = untilChain(m.vars, size, false);
+			// a chain of untils implies its last term eventually holds
+			f2 << "(" << f1 << ") & F " << m.vars[size-1];
+		} else {
+			ctl.add(fairness(m.vars, size, true));
+			f1 = fairness(m.vars, size, false);
+			f2 = fairness(m.vars, size, false, true);
+		}
+		ltl.add(f1);
+		check(fam, size, ctl, ltl);
+
+		Formula g1, g2;
+		parseFormula(f1, g1);
+		parseFormula(f2, g2);
+
+		String discard;
+		double start = startPhase();
+		Utils::pushSink(&discard);
+		LTLCheck c(vars_, LTLCheck::OPT_BRIEF);
+		c.compare(g1, g2);
+		Utils::popSink();
+		report(fam, size, model_.states(), "compare", start, -1);
+		return;
+	}
+
+	if (family.equals("mutex"))
+		genMutex(size, m);
+	else if (family.equals("phil"))
+		genPhilosophers(size, m);
+	else if (family.equals("ring"))
+		genRing(size, m);
+	else if (family.equals("grid"))
+		genGrid(size, m);
+	else if (family.equals("random"))
+		genRandom(size, degree_, maxVal(k_, 1), m);
+	else {
+		String s("Unknown family: ");
+		s << family;
+		throw CmdArgException(s);
+	}
+
+	parseModel(fam, size, m);
+
+	ctl.add(untilChain(m.vars, k_, true));
+	ctl.add(fairness(m.vars, k_, true));
+	ltl.add(untilChain(m.vars, k_, false));
+	ltl.add(fairness(m.vars, k_, false));
+	check(fam, size, ctl, ltl);
+}
+
+int main(int argc, char** argv) {
+
+	DFA dfa;
+	{
+		ByteBufferReader rd(_dfa);
+		dfa.read(rd);
+	}
+
+	Context context;
+	Context::Use useContext(context);
+
+	Bench bench(dfa, context.vars());
+	int step = 1;
+	bool doubling = false;
+	int seed = 1965;
+
+	CmdArgs args(argc,argv);
+	try {
+		while (true) {
+			if (args.peekOption('h'))
+				throw CmdArgException("");
+			if (args.peekOption('k')) {
+				bench.k_ = args.nextInt();
+				continue;
+			}
+			if (args.peekOption('d')) {
+				bench.degree_ = args.nextInt();
+				continue;
+			}
+			if (args.peekOption('n')) {
+				bench.states_ = args.nextInt();
+				continue;
+			}
+			if (args.peekOption('i')) {
+				step = args.nextInt();
+				continue;
+			}
+			if (args.peekOption('g')) {
+				doubling = true;
+				continue;
+			}
+			if (args.peekOption('s')) {
+				seed = args.nextInt();
+				continue;
+			}
+			break;
+		}
+
+		String family = args.nextValue();
+		int first = args.nextInt();
+		int last = first;
+		if (args.hasNext())
+			last = args.nextInt();
+		args.done();
+
+		if (first < 1 || step < 1 || bench.k_ < 1)
+			throw CmdArgException("Sizes must be positive");
+
+		Utils::srand(seed);
+
+		Cout << "family    size    states  phase       time(ms)   states/sec   peak(KB)  by subsystem (KB)\n";
+		for (int size = first; size <= last;
+			size = (doubling ? size * 2 : size + step)) {
+			bench.run(family, size);
+			context.forest().reclaim();
+		}
+
+	} catch (CmdArgException &e) {
+		Cout << e
+			<< "Usage: mchbench <opts> <family> <first size> [<last size>]\n"
+			<< "<family> is one of:\n"
+			<< "  mutex         : mutual exclusion; size = # processes\n"
+			<< "  phil          : dining philosophers; size = # philosophers\n"
+			<< "  ring          : ring; size = # states\n"
+			<< "  grid          : grid; size = width\n"
+			<< "  random        : random graph; size = # states\n"
+			<< "  until         : chains of U; size = # variables\n"
+			<< "  fair          : conjunctions of G F; size = # variables\n"
+			<< "<opts> include:\n"
+			<< " -d <n>         : degree of random graphs (default 3)\n"
+			<< " -g             : double size at each step\n"
+			<< " -h             : print help\n"
+			<< " -i <n>         : increase size by n at each step (default 1)\n"
+			<< " -k <n>         : # variables in formulas for model families\n"
+			<< "                      (default 3)\n"
+			<< " -n <n>         : # states in models for formula families\n"
+			<< "                      (default 64)\n"
+			<< " -s <n>         : random number seed\n"
+			;
+	} catch (Exception &e) {
+		Utils::useSink(&Utils::getErrorSink());
+		Cout << e;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include "globals.h"
+
+Arena::Arena(int chunkSize)
+{
+	ASSERT(chunkSize > 0);
+	chunkSize_ = chunkSize;
+	next_ = 0;
+	left_ = 0;
+	size_ = 0;
+	account_ = MemAccount::OTHER;
+}
+
+void *Arena::allocChunk(int bytes)
+{
+	// requests that would waste much of a chunk get one of their own,
+	// leaving the current chunk in use
+	bool own = (bytes > chunkSize_ / 4);
+	int size = own ? bytes : chunkSize_;
+
+	if (chunks_.isEmpty())
+		account_ = MemAccount::current();
+	MemAccount::charge(account_, size);
+
+	char *chunk;
+	NewArray(chunk, size);
+	chunks_.add(chunk);
+	chunkSizes_.add(size);
+	size_ += size;
+
+	if (own)
+		return chunk;
+
+	next_ = chunk + bytes;
+	left_ = size - bytes;
+	return chunk;
+}
+
+void Arena::clear()
+{
+	while (!chunks_.isEmpty()) {
+		char *chunk = chunks_.pop();
+		MemAccount::release(account_, chunkSizes_.pop());
+		DeleteArray(chunk);
+	}
+	next_ = 0;
+	left_ = 0;
+	size_ = 0;
+}
+
+ArenaSet& ArenaSet::operator=(const ArenaSet &s)
+{
+	if (&s != this) {
+		if (arena_ == 0)
+			arena_ = s.arena_;
+		length_ = 0;
+		ensureCapacity(s.length_ + COPY_SLACK);
+		for (int i = 0; i < s.length_; i++)
+			items_[i] = s.items_[i];
+		length_ = s.length_;
+	}
+	return *this;
+}
+
+void ArenaSet::ensureCapacity(int n)
+{
+	if (n <= capacity_)
+		return;
+
+	ASSERT(arena_ != 0);
+	int newCapacity = maxVal(n, capacity_ * 2);
+	int *newItems = arena_->allocInts(newCapacity);
+	for (int i = 0; i < length_; i++)
+		newItems[i] = items_[i];
+	items_ = newItems;
+	capacity_ = newCapacity;
+}
+
+void ArenaSet::add(int n)
+{
+	int i = 0;
+	while (i < length_) {
+		if (items_[i] == n) return;
+		if (items_[i] > n) break;
+		i++;
+	}
+	ensureCapacity(length_ + 1);
+	for (int j = length_; j > i; j--)
+		items_[j] = items_[j - 1];
+	items_[i] = n;
+	length_++;
+}
+
+void ArenaSet::removeArrayItem(int pos)
+{
+	ASSERT(pos >= 0 && pos < length_);
+	for (int j = pos + 1; j < length_; j++)
+		items_[j - 1] = items_[j];
+	length_--;
+}
+
+void ArenaSet::include(const ArenaSet &src)
+{
+	// count the new items, so at most one buffer is allocated
+	int extra = 0;
+	{
+		int j = 0;
+		for (int i = 0; i < src.length_; i++) {
+			int n = src.items_[i];
+			while (j < length_ && n > items_[j])
+				j++;
+			if (j == length_ || n != items_[j])
+				extra++;
+		}
+	}
+	if (extra == 0)
+		return;
+	ensureCapacity(length_ + extra);
+
+	// merge from the end, so items are moved at most once
+	int i = src.length_ - 1;
+	int j = length_ - 1;
+	int k = length_ + extra - 1;
+	while (i >= 0) {
+		int n = src.items_[i];
+		if (j >= 0 && items_[j] > n)
+			items_[k--] = items_[j--];
+		else {
+			if (j >= 0 && items_[j] == n)
+				j--;
+			items_[k--] = n;
+			i--;
+		}
+	}
+	length_ += extra;
+}
+
+bool ArenaSet::equals(const ArenaSet &s) const
+{
+	if (length_ != s.length_) return false;
+	for (int i = 0; i < length_; i++)
+		if (items_[i] != s.items_[i]) return false;
+	return true;
+}
+
+bool ArenaSet::contains(int n) const
+{
+	for (int i = 0; i < length_; i++) {
+		if (items_[i] > n)
+			break;
+		if (items_[i] == n)
+			return true;
+	}
+	return false;
+}
+
+#if DEBUG
+String ArenaSet::debInfo() const
+{
+	String s("(");
+	for (int i = 0; i < length(); i++) {
+		if (i != 0)
+			s << " ";
+		s << itemAt(i);
+	}
+	s << ")";
+	return s;
+}
+#endif
@@ -0,0 +1,157 @@
+#ifndef _ARENA
+#define _ARENA
+
+#include <new>
+
+/*	Arena: allocates memory from large chunks by advancing a pointer.
+		Individual allocations are never freed; instead, the whole arena
+		is released at once by clear().  This suits data structures that
+		are built, used, and discarded together, such as the tableau
+		built while translating an LTL formula.
+
+		Objects with destructors must not be placed in an arena, since
+		they won't be called.
+*/
+class Arena {
+public:
+	/*	Constructor
+			> chunkSize				size of each chunk, in bytes
+	*/
+	Arena(int chunkSize = 1 << 16);
+	~Arena() {clear();}
+
+	/*	Allocate memory
+			> bytes						number of bytes required
+			< pointer to memory, aligned for any type
+	*/
+	void *alloc(int bytes) {
+		bytes = (bytes + ALIGN - 1) & ~(ALIGN - 1);
+		if (bytes > left_)
+			return allocChunk(bytes);
+		void *p = next_;
+		next_ += bytes;
+		left_ -= bytes;
+		return p;
+	}
+
+	/*	Allocate an array of integers
+			> n								number of integers
+			< pointer to array
+	*/
+	int *allocInts(int n) {
+		return (int *)alloc(n * sizeof(int));
+	}
+
+	/*	Release all memory allocated from the arena
+	*/
+	void clear();
+
+	/*	Get total size of the chunks allocated
+	*/
+	long long size() const {return size_;}
+
+private:
+	// no copying allowed
+	Arena(const Arena &s);
+	Arena& operator=(const Arena &s);
+
+	enum {
+		ALIGN = 8
+	};
+
+	/*	Allocate memory from a new chunk
+			> bytes						number of bytes required (aligned)
+			< pointer to memory
+	*/
+	void *allocChunk(int bytes);
+
+	// chunks allocated
+	Array<char *> chunks_;
+	// sizes of chunks
+	Array<int> chunkSizes_;
+	// next free byte in current chunk
+	char *next_;
+	// bytes remaining in current chunk
+	int left_;
+	int chunkSize_;
+	long long size_;
+	// account chunks are charged to (see MemAccount)
+	int account_;
+};
+
+/*	Ordered set of integers, whose storage is allocated from an Arena.
+		Copying a set allocates a new buffer from the arena, and the
+		old buffer is abandoned when a set grows; both are reclaimed when
+		the arena is cleared.
+*/
+class ArenaSet {
+public:
+	ArenaSet() {
+		construct(0);
+	}
+	ArenaSet(Arena &arena) {
+		construct(&arena);
+	}
+	ArenaSet(const ArenaSet &s) {
+		construct(s.arena_);
+		*this = s;
+	}
+	ArenaSet& operator=(const ArenaSet &s);
+
+	/*	Exchange contents with another set, without copying
+	*/
+	void swap(ArenaSet &s) {
+		swapVal(arena_, s.arena_);
+		swapVal(items_, s.items_);
+		swapVal(length_, s.length_);
+		swapVal(capacity_, s.capacity_);
+	}
+
+	void clear() {length_ = 0;}
+	void add(int n);
+	void removeArrayItem(int pos);
+
+	int length() const {return length_;}
+	int itemAt(int pos) const {
+		ASSERT(pos >= 0 && pos < length_);
+		return items_[pos];
+	}
+	int operator[](int i) const {return itemAt(i);}
+
+	/*	Add all elements of another set to this one
+	*/
+	void include(const ArenaSet &src);
+
+	bool isEmpty() const {return (length() == 0);}
+	bool equals(const ArenaSet &s) const;
+	bool contains(int n) const;
+#if DEBUG
+	String debInfo() const;
+#endif
+
+private:
+	void construct(Arena *arena) {
+		arena_ = arena;
+		items_ = 0;
+		length_ = 0;
+		capacity_ = 0;
+	}
+
+	/*	Make room for at least n items, moving them to a larger
+			buffer if necessary
+	*/
+	void ensureCapacity(int n);
+
+	// extra room allocated when a set is copied, since the tableau
+	// usually adds an item or two to a copy
+	enum {
+		COPY_SLACK = 2
+	};
+
+	Arena *arena_;
+	int *items_;
+	int length_;
+	int capacity_;
+};
+
+#endif // _ARENA
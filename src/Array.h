@@ -20,11 +20,27 @@ public:
 	Array(const Array &s);
 	// assignment operator
 	Array& operator=(const Array &s);
+#if HAS_MOVE
+	// move constructor
+	Array(Array &&s) {
+		construct();
+		swap(s);
+	}
+	// move assignment operator
+	Array& operator=(Array &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
 	// initializer
 private:
 	void construct();
 	// --------------------------------
 public:
+	/*	Exchange contents with another array, without copying items
+	*/
+	void swap(Array &s);
+
 	T &operator[](int i) const {return itemAt(i);}
 	T &itemAt(int i) const {
 		ASSERT(i >= 0 && i < used_);
@@ -33,6 +49,15 @@ public:
 	void add(const T &item);
 	T &last() const {return itemAt(length()-1);}
 
+	/*	Add an item by moving it (see moveValue()); the item is left
+			in an unspecified state
+	*/
+	void addMove(T &item) {
+		ensureCapacity(used_+1);
+		used_++;
+		moveValue(buffer_[used_-1], item);
+	}
+
 	/*	Add an item to a particular slot; increase buffer if necessary
 	*/
 	void add(const T &item, int loc);
@@ -121,6 +146,9 @@ protected:
 private:
 	void growCapacity(int newCapacity, bool expectFutureGrowth = true);
 
+	// account buffer is charged to (see MemAccount)
+	int account_;
+
 #if DEBUG
 	int lockValue_;
 	bool trace_;
@@ -168,6 +196,7 @@ void Array<T>::construct() {
 	capacity_ = 0;
 	used_ = 0;
 	buffer_ = 0;
+	account_ = MemAccount::OTHER;
 #if DEBUG
 	lockValue_ = 0;
 	trace_ = false;
@@ -178,11 +207,23 @@ template<typename T>
 Array<T>::~Array()
 {
 	if (buffer_ != 0) {
+		MemAccount::release(account_, sizeof(T) * (long long)capacity_);
 		DeleteArray(buffer_);
 	}
 	DESTROY();
 }
 
+template<typename T>
+void Array<T>::swap(Array<T> &s)
+{
+	ASSERT2(lockValue_ == 0 && s.lockValue_ == 0,
+		"Attempt to swap locked array");
+	swapVal(used_, s.used_);
+	swapVal(capacity_, s.capacity_);
+	swapVal(buffer_, s.buffer_);
+	swapVal(account_, s.account_);
+}
+
 template<typename T>
 Array<T>::Array(const Array<T> &s)
 {
@@ -246,7 +287,7 @@ void Array<T>::replace(int offset, int delCount, const T *src, int insCount)
 		for (int i = offset + delCount; i < used_; i++) {
 			//                              ^ was <=!!!
 			pt((" shiftBwd %d -> %d\n",i,i-shift));
-			buffer_[i - shift] = buffer_[i];
+			moveValue(buffer_[i - shift], buffer_[i]);
 		}
 
 		used_ -= shift;
@@ -259,7 +300,7 @@ void Array<T>::replace(int offset, int delCount, const T *src, int insCount)
 		int shift = insCount - delCount;
 		for (int i = used_ - 1; i >= offset + delCount; i--) {
 			pt((" shiftFwd %d -> %d\n",i,i+shift));
-			buffer_[i + shift] = buffer_[i];
+			moveValue(buffer_[i + shift], buffer_[i]);
 		}
 		used_ += shift;
 		delCount = insCount;
@@ -300,12 +341,17 @@ void Array<T>::resize(int newCapacity)
 				pr(("resizing array %p from %d to %d\n",this,capacity_,newCapacity));
 			}
 #endif
+			// charge the new buffer to the current account; this
+			// throws if the memory budget would be exceeded
+			int account = MemAccount::current();
+			MemAccount::charge(account, sizeof(T) * (long long)newCapacity);
+
 			T *nBuff;
 			NewArray(nBuff,newCapacity);
 			ASSERT(newCapacity >= used_);
 
 			for (int i = 0; i < used_; i++) {
-				nBuff[i] = buffer_[i];
+				moveValue(nBuff[i], buffer_[i]);
 			}
 			ASSERT2(lockValue_ == 0,"Attempt to resize locked array");
 
@@ -313,8 +359,10 @@ void Array<T>::resize(int newCapacity)
 				pd((" deleting old %p\n",buffer_));
 				DeleteArray(buffer_);
 			}
+			MemAccount::release(account_, sizeof(T) * (long long)capacity_);
 			buffer_ = nBuff;
 			capacity_ = newCapacity;
+			account_ = account;
 		}
 }
 
@@ -369,6 +417,13 @@ String Array<T>::debInfo(bool small) const
 }
 #endif
 
+/*	Move an array, by exchanging its contents with the destination's
+*/
+template <typename T>
+inline void moveValue(Array<T> &dest, Array<T> &src) {
+	dest.swap(src);
+}
+
 typedef Array<char> CharArray;
 #if DEBUG
 void Test_Array();
@@ -7,6 +7,26 @@ public:
 		construct();
 	}
 	virtual ~BitStore() {}
+#if HAS_MOVE
+	BitStore(const BitStore &s) = default;
+	BitStore& operator=(const BitStore &s) = default;
+	BitStore(BitStore &&s) {
+		construct();
+		swap(s);
+	}
+	BitStore& operator=(BitStore &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
+
+	/*	Exchange contents with another store, without copying
+	*/
+	void swap(BitStore &s) {
+		store_.swap(s.store_);
+		swapVal(length_, s.length_);
+		swapVal(cursor_, s.cursor_);
+	}
 
 	/*	Add some bits to the store
 			> data						bits to add (least sig bit added first)
@@ -210,6 +230,10 @@ private:
 	int cursor_;
 };
 
+inline void moveValue(BitStore &dest, BitStore &src) {
+	dest.swap(src);
+}
+
 #if DEBUG
 void Test_BitStore();
 #endif
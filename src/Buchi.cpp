@@ -1,5 +1,23 @@
 #include "globals.h"
 
+void Buchi::swap(Buchi &s)
+{
+	states_.swap(s.states_);
+	initialStates_.swap(s.initialStates_);
+	acceptSets_.swap(s.acceptSets_);
+	contradictionStates_.swap(s.contradictionStates_);
+	hashed_.swap(s.hashed_);
+	flagged_.swap(s.flagged_);
+	dfsStack1_.swap(s.dfsStack1_);
+	dfsStack2_.swap(s.dfsStack2_);
+	stacked_.swap(s.stacked_);
+	swapVal(cancel_, s.cancel_);
+	swapVal(dfsVisits_, s.dfsVisits_);
+	swapVal(labelKind_, s.labelKind_);
+	swapVal(labelVars_, s.labelVars_);
+	labelLits_.swap(s.labelLits_);
+}
+
 int Buchi::addState(bool initial)
 {
 	State s;
@@ -20,32 +38,30 @@ void Buchi::addTransition(int src, int dest)
 
 void Buchi::addPropVar(int state, int varNum, bool value)
 {
-	State &st = states_[state];
-	if (value)
-		st.pvTrue_.set(varNum);
-	else
-		st.pvFalse_.set(varNum);
+	states_[state].lits_.add(varNum, value);
 }
 
 void Buchi::print() {
-	Vars *v = Vars::globalPtr();
+	Vars *v = &Context::current().vars();
 
 	//Cout << "------------- Buchi automaton ----------------------\n";
+	// reuse one string for every line
+	String s;
 	for (int i = 0; i < states_.length(); i++) {
 
 		State &st = states_[i];
 
-		String s; 
+		s.clear();
 		s << (initialStates_.contains(i) ? '>' : ' ');
 		s << fmt(i,3) << ": ";
 		
-		int maxVar = maxVal(st.pvTrue_.length(), st.pvFalse_.length() );
+		int maxVar = st.lits_.length();
 
 		bool printed = false;
 		for (int j = 0; j < maxVar; j++) {
 
-			bool f0 = st.pvTrue_.get(j),
-				f1 = st.pvFalse_.get(j);
+			bool f0 = st.lits_.mustBeTrue(j),
+				f1 = st.lits_.mustBeFalse(j);
 
 			if (!(f0 || f1)) 
 				continue;
@@ -74,9 +90,9 @@ void Buchi::print() {
 		for (int j = 0; j < st.trans_.length(); j++)
 			s << st.trans_[j] << ' ';
 
-		if (st.label_.defined()) {
+		if (st.label_ >= 0) {
 			s.pad(40);
-			s << st.label_;
+			s << stateLabel(i);
 		}
 		Cout << s << "\n";
 	}
@@ -141,7 +157,7 @@ void Buchi::convertGeneralized(Buchi &d)
 		for (int i = 0; i < nStates(); i++) {
 			set.set(i + rowSize * (qm-1));
 		}
-		d.addAcceptSet(set);
+		d.addAcceptSetMove(set);
 	}
 
 	// define transitions
@@ -171,23 +187,18 @@ void Buchi::convertGeneralized(Buchi &d)
 		State &st = states_[i];
 		for (int j = 0; j < qm; j++) {
 			State &sd = d.states_[i+rowSize*j];
-			sd.pvFalse_ = st.pvFalse_;
-			sd.pvTrue_ = st.pvTrue_;
-
-			//if (j == 0)	pt((" i=%d pvTrue set to %s\n pvFalse set to %s\n",i,sd.pvTrue_.s(true),sd.pvFalse_.s(true) ));
+			sd.lits_ = st.lits_;
 		}
 	}
 }
 
-void Buchi::convertKripke(const Model &m, const Vars &v)
+void Buchi::convertKripke(const Model &m, int totVars)
 {
 #if DEBUG
 	if (m.initialStates().length() == 0)
 		Cout << "*** Warning: converting Kripke model with no initial states\n";
 #endif
 
-	int totVars = v.length();
-
 	clear();
 
 	// create an initial state
@@ -195,9 +206,7 @@ void Buchi::convertKripke(const Model &m, const Vars &v)
 
 	for (int i = 0; i < m.states(); i++) {
 		int id = addState();
-		String w;
-		w << m.stateName(i);
-		addStateLabel(id, w);
+		setStateName(id, m.stateName(i));
 	}
 
 	for (int i = 0; i < m.states(); i++) {
@@ -223,7 +232,7 @@ void Buchi::convertKripke(const Model &m, const Vars &v)
 	BitStore set;
 	for (int i = 0; i < nStates(); i++)
 		set.set(i);
-	addAcceptSet(set);
+	addAcceptSetMove(set);
 
 	//pr(("converted to kripke\n%s",s() ));
 
@@ -247,13 +256,14 @@ void Buchi::calcProduct(const Buchi &b1, const Buchi &b2)
 	int rowSize = q1;
 	int pageSize = rowSize * q2;
 
-	// add |Q1| * |Q2| * 3 states
-	for (int i = 0; i < q1 * q2 * 3; i++) {
+	// if every state of b1 is accepting, only one page is needed
+	int pages = b1.allAccepting() ? 1 : 3;
 
+	// add |Q1| * |Q2| * pages states, each with the label of its b1 state
+	copyLabels(b1);
+	for (int i = 0; i < pageSize * pages; i++) {
 		int id = addState();
-//		if (i < q1) {
-			addStateLabel(id, b1.stateLabel(id % q1));
-//		}
+		states_[id].label_ = b1.states_[id % q1].label_;
 	}
 
 	// construct propVars, and determine if they are a contradiction.
@@ -264,29 +274,23 @@ void Buchi::calcProduct(const Buchi &b1, const Buchi &b2)
 		State &si = b1.states_[i];
 		for (int j = 0; j < q2; j++) {
 			State &sj = b2.states_[j];
-			for (int k = 0; k < 2; k++) 
+			for (int k = 0; k < minVal(pages, 2); k++) 
 			{
 				int d0 = (i + rowSize*j);
 				int di = d0 + k * pageSize;
 
+				// (its label was set when the state was added)
 				State &d = states_[di];
-				d.label_.set(si.label_);
 
 				if (k == 0) {
-					d.pvFalse_ = si.pvFalse_;
-					d.pvTrue_ = si.pvTrue_;
-					d.pvFalse_.bitwiseOr(sj.pvFalse_);
-					d.pvTrue_.bitwiseOr(sj.pvTrue_);
 					// determine if any contradictions exist
-					BitStore test;
-					test = d.pvTrue_;
-					test.bitwiseAnd(d.pvFalse_);
-					if (test.countBits() != 0)
+					if (!si.lits_.compatible(sj.lits_))
 						contradictionStates_.set(di);
+					d.lits_ = si.lits_;
+					d.lits_.include(sj.lits_);
 				} else {
 					State &src = states_[d0];
-					d.pvFalse_ = src.pvFalse_;
-					d.pvTrue_ = src.pvTrue_;
+					d.lits_ = src.lits_;
 					contradictionStates_.set(di, contradictionStates_[d0]);
 				}
 			}
@@ -309,10 +313,14 @@ void Buchi::calcProduct(const Buchi &b1, const Buchi &b2)
 		BitStore set;
 		for (int i = 0; i < q1; i++) {
 			for (int j = 0; j < q2; j++) {
-				set.set((i + j*rowSize) + 2 * pageSize);
+				if (pages == 1) {
+					if (b2.accepting(j))
+						set.set(i + j*rowSize);
+				} else
+					set.set((i + j*rowSize) + 2 * pageSize);
 			}
 		}
-		addAcceptSet(set);
+		addAcceptSetMove(set);
 	}
 
 	// define transitions
@@ -332,6 +340,11 @@ void Buchi::calcProduct(const Buchi &b1, const Buchi &b2)
 						continue;
 					}
 
+					if (pages == 1) {
+						addTransition(ri + qj * rowSize, rm + qn * rowSize);
+						continue;
+					}
+
 					for (int x = 0; x < 3; x++) {
 						int y = x;
 						switch (x) {
@@ -357,6 +370,24 @@ void Buchi::calcProduct(const Buchi &b1, const Buchi &b2)
 
 }
 
+int Buchi::nTransitions() const
+{
+	int n = 0;
+	for (int i = 0; i < nStates(); i++)
+		n += states_[i].trans_.length();
+	return n;
+}
+
+bool Buchi::allAccepting() const
+{
+	if (nAcceptSets() != 1)
+		return false;
+	for (int i = 0; i < nStates(); i++)
+		if (!accepting(i))
+			return false;
+	return true;
+}
+
 bool Buchi::accepting(int state, int set) const {
 	ASSERT(set >= 0 && set < nAcceptSets());
 	return acceptSets_[set].get(state);
@@ -369,6 +400,7 @@ bool Buchi::nonEmpty(Array<int> &seq)
 	hashed_.clear();
 	dfsStack1_.clear();
 	dfsStack2_.clear();
+	dfsVisits_ = 0;
 
 	bool result = false;
 
@@ -390,6 +422,9 @@ bool Buchi::nonEmpty(Array<int> &seq)
 bool Buchi::dfs1(int q)
 {
 	bool result = false;
+	if (cancelled())
+		return result;
+	dfsVisits_++;
 
 	stacked_.set(q);
 	dfsStack1_.add(q);
@@ -419,10 +454,14 @@ bool Buchi::dfs1(int q)
 
 bool Buchi::dfs2(int q)
 {
+	bool result = false;
+	if (cancelled())
+		return result;
+	dfsVisits_++;
+
 	dfsStack2_.add(q);
 	flagged_.set(q);
 	State &st = states_[q];
-	bool result = false;
 
 	for (int i = 0; i < st.trans_.length(); i++) {
 		int q2 = st.trans_[i];
@@ -445,41 +484,60 @@ bool Buchi::dfs2(int q)
 
 void Buchi::setPropVarLabels(Vars &v)
 {
+	labelKind_ = LABEL_LITS;
+	labelVars_ = &v;
+	labelLits_.clear();
 	for (int j = 0; j < nStates(); j++) {
-
 		State &s = states_[j];
-		String d;
-		
-		int litCnt = 0;
+		labelLits_.add(s.lits_);
+		s.label_ = j;
+	}
+}
 
-		for (int i = 0; i < v.length(); i++) {
-			if (s.pvTrue_[i] && s.pvFalse_[i]) {
-				litCnt = 1;
-				d.set("B");
-				break;
-			}
+String Buchi::stateLabel(int state) const
+{
+	String d;
+	int label = states_[state].label_;
+	if (label < 0)
+		return d;
+
+	if (labelKind_ == LABEL_NAME) {
+		d << label;
+		return d;
+	}
 
-			if (s.pvTrue_[i] || s.pvFalse_[i]) {
-				if (litCnt == 1) {
-					d.insert(0,"(");
-				}
-				if (litCnt > 0)
-					d << " ^ ";
-				litCnt++;
-				if (s.pvFalse_[i])
-					d << '!';
-				d << v.var(i);
-			}
+	const Literals &lits = labelLits_[label];
+	Vars &v = *labelVars_;
+
+	int litCnt = 0;
+
+	for (int i = 0; i < v.length(); i++) {
+		bool t = lits.mustBeTrue(i), f = lits.mustBeFalse(i);
+		if (t && f) {
+			litCnt = 1;
+			d.set("B");
+			break;
 		}
-		if (litCnt == 0) {
-			d << 'T';
+
+		if (t || f) {
+			if (litCnt == 1) {
+				d.insert(0,"(");
+			}
+			if (litCnt > 0)
+				d << " ^ ";
 			litCnt++;
+			if (f)
+				d << '!';
+			d << v.var(i);
 		}
-		if (litCnt > 1)
-			d << ')';
-
-		addStateLabel(j,d);
 	}
+	if (litCnt == 0) {
+		d << 'T';
+		litCnt++;
+	}
+	if (litCnt > 1)
+		d << ')';
+	return d;
 }
 
 void Buchi::reduce(Buchi &d)
@@ -490,6 +548,7 @@ void Buchi::reduce(Buchi &d)
 	p2(("Reduce:\n%s",s()));
 
 	d.clear();
+	d.copyLabels(*this);
 
 	BitStore flagged;
 	Stack<int> stk;
@@ -513,6 +572,14 @@ void Buchi::reduce(Buchi &d)
 
 	p2(("flagged=%s\n",flagged.s(true) ));
 
+	// of the reachable states, keep only those that can reach an
+	// accepting cycle
+	BitStore live;
+	findLiveStates(flagged, live);
+	flagged = live;
+
+	p2(("live=%s\n",flagged.s(true) ));
+
 	Array<int> newId;
 	Array<int> oldId;
 
@@ -530,18 +597,21 @@ void Buchi::reduce(Buchi &d)
 	for (int i = 0;  i < nStates(); i++) {
 		if (!flagged[i]) continue;
 		State &orig = states_[i];
-		State s = orig;
-		Array<int> &t = s.trans_;
-		for (int j = 0; j < t.length(); j++) {
-			int dest = t[j];
+		State s;
+		s.lits_ = orig.lits_;
+		s.label_ = orig.label_;
+		for (int j = 0; j < orig.trans_.length(); j++) {
+			int dest = orig.trans_[j];
 			if (!flagged[dest]) continue;
-			t.set(j, newId[dest]);
+			s.trans_.add(newId[dest]);
 		}
-		d.states_.add(s);
+		d.states_.addMove(s);
 	}
 
 	for (int i = 0; i < initialStates_.length(); i++) {
-		d.initialStates_.add(newId[initialStates_[i]]);
+		int q = initialStates_[i];
+		if (!flagged[q]) continue;
+		d.initialStates_.add(newId[q]);
 	}
 
 	for (int j = 0; j < acceptSets_.length(); j++) {
@@ -554,8 +624,333 @@ void Buchi::reduce(Buchi &d)
 			int k = newId[i];
 			set.set(k);
 		}
-		d.acceptSets_.add(set);
+		d.acceptSets_.addMove(set);
 	}
 
 	p2(("Reduced:\n%s",d.s()));
 }
+
+bool Buchi::emptyLabel(int state) const
+{
+	return states_[state].lits_.contradiction();
+}
+
+bool Buchi::labelImplies(int a, int b, const BitStore &dead) const
+{
+	if (dead[a]) return true;
+	return states_[a].lits_.contains(states_[b].lits_);
+}
+
+/*	r simulates q if label(q) implies label(r), r is in every accept
+		set that q is in, and every move q->q' can be matched by
+		a move r->r' where r' simulates q'.  We start with every pair
+		satisfying the first two conditions, and remove pairs until
+		the third holds (greatest fixed point).
+*/
+void Buchi::calcSimulation(const BitStore &dead, Array<BitStore> &sim) const
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	int n = nStates();
+
+	sim.clear();
+	for (int q = 0; q < n; q++) {
+		BitStore row;
+		for (int r = 0; r < n; r++) {
+			bool ok = labelImplies(q, r, dead);
+			for (int k = 0; ok && k < nAcceptSets(); k++)
+				if (accepting(q,k) && !accepting(r,k))
+					ok = false;
+			if (ok)
+				row.set(r);
+		}
+		sim.add(row);
+	}
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int q = 0; q < n; q++) {
+			State &sq = states_[q];
+			for (int r = 0; r < n; r++) {
+				if (r == q || !sim[q][r]) continue;
+				State &sr = states_[r];
+
+				for (int i = 0; i < sq.trans_.length(); i++) {
+					int q2 = sq.trans_[i];
+					if (dead[q2]) continue;
+
+					bool matched = false;
+					for (int j = 0; j < sr.trans_.length(); j++) {
+						if (sim[q2][sr.trans_[j]]) {
+							matched = true;
+							break;
+						}
+					}
+					if (!matched) {
+						p2((" %d no longer simulates %d\n",r,q));
+						sim[q].set(r, false);
+						changed = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+void Buchi::simulationReduce(Buchi &d)
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	p2(("simulationReduce:\n%s",s()));
+
+	int n = nStates();
+
+	BitStore dead;
+	for (int i = 0; i < n; i++)
+		if (emptyLabel(i))
+			dead.set(i);
+
+	Array<BitStore> sim;
+	calcSimulation(dead, sim);
+
+	// assign each state to a class of mutually similar states;
+	// each class is represented by its lowest-numbered state.  Initial
+	// states aren't merged with others: they have no predecessors, and
+	// a merged state could be returned to by a path through it, which
+	// would make sequences repeat from their starting state.
+	Array<int> cls;
+	Array<int> rep;
+	for (int q = 0; q < n; q++) {
+		int c = -1;
+		for (int j = 0; j < rep.length(); j++) {
+			int r = rep[j];
+			if (initialStates_.contains(q) || initialStates_.contains(r))
+				continue;
+			if (sim[q][r] && sim[r][q]) {
+				c = j;
+				break;
+			}
+		}
+		if (c < 0) {
+			c = rep.length();
+			rep.add(q);
+		}
+		cls.add(c);
+	}
+
+	Buchi t;
+	t.copyLabels(*this);
+	for (int c = 0; c < rep.length(); c++) {
+		int id = t.addState();
+		State &src = states_[rep[c]];
+		State &dst = t.states_[id];
+		dst.lits_ = src.lits_;
+		dst.label_ = src.label_;
+	}
+
+	// collect the successor classes of each class
+	Array<OrdSet> succ;
+	for (int c = 0; c < rep.length(); c++) {
+		OrdSet empty;
+		succ.add(empty);
+	}
+	for (int q = 0; q < n; q++) {
+		State &st = states_[q];
+		for (int i = 0; i < st.trans_.length(); i++) {
+			int q2 = st.trans_[i];
+			if (dead[q2]) continue;
+			succ[cls[q]].add(cls[q2]);
+		}
+	}
+
+	// add transitions, omitting those to a class that is simulated
+	// by another successor class (since the classes are disjoint,
+	// the simulation between distinct classes is strict, and
+	// every omitted transition is covered by a maximal one that remains)
+	for (int c = 0; c < rep.length(); c++) {
+		OrdSet &sc = succ[c];
+		for (int i = 0; i < sc.length(); i++) {
+			int a = sc[i];
+			bool dominated = false;
+			for (int j = 0; j < sc.length(); j++) {
+				int b = sc[j];
+				if (b != a && sim[rep[a]][rep[b]]) {
+					dominated = true;
+					break;
+				}
+			}
+			if (!dominated)
+				t.addTransition(c, a);
+		}
+	}
+
+	// add initial states, omitting those that are simulated by others
+	{
+		OrdSet init;
+		for (int i = 0; i < initialStates_.length(); i++)
+			init.add(cls[initialStates_[i]]);
+		for (int i = 0; i < init.length(); i++) {
+			int a = init[i];
+			bool dominated = false;
+			for (int j = 0; j < init.length(); j++) {
+				int b = init[j];
+				if (b != a && sim[rep[a]][rep[b]]) {
+					dominated = true;
+					break;
+				}
+			}
+			if (!dominated)
+				t.initialStates_.add(a);
+		}
+	}
+
+	for (int k = 0; k < nAcceptSets(); k++) {
+		BitStore set;
+		for (int c = 0; c < rep.length(); c++)
+			if (accepting(rep[c],k))
+				set.set(c);
+		t.addAcceptSetMove(set);
+	}
+
+	p2(("quotient:\n%s",t.s()));
+
+	t.reduce(d);
+}
+
+/*	Uses Tarjan's algorithm (iteratively, since the automata can be
+		large enough to overflow the stack).  Components are completed
+		in reverse topological order, so when a component is completed,
+		every component it has transitions to has already been classified.
+*/
+void Buchi::findLiveStates(const BitStore &reach, BitStore &live) const
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	int n = nStates();
+	live.clear();
+
+	// order in which states were discovered, or -1 if not yet
+	Array<int> index;
+	// lowest index reachable from state through its subtree
+	Array<int> low;
+	// component state belongs to, or -1 if not yet assigned
+	Array<int> comp;
+	for (int i = 0; i < n; i++) {
+		index.add(-1);
+		low.add(0);
+		comp.add(-1);
+	}
+
+	// flags for components that can reach an accepting cycle
+	BitStore liveComp;
+	int nComp = 0;
+	int counter = 0;
+
+	Stack<int> sccStack;
+	BitStore onStack;
+
+	// dfs stack of states, and the next transition to follow from each
+	Stack<int> callStack;
+	Stack<int> edgeStack;
+
+	for (int root = 0; root < n; root++) {
+		if (!reach[root] || index[root] >= 0) continue;
+
+		index.set(root, counter);
+		low.set(root, counter);
+		counter++;
+		sccStack.push(root);
+		onStack.set(root);
+		callStack.push(root);
+		edgeStack.push(0);
+
+		while (!callStack.isEmpty()) {
+			int q = callStack.peek();
+			int e = edgeStack.peek();
+			State &st = states_[q];
+
+			if (e < st.trans_.length()) {
+				edgeStack.set(edgeStack.length()-1, e+1);
+				int q2 = st.trans_[e];
+				if (!reach[q2]) continue;
+				if (index[q2] < 0) {
+					index.set(q2, counter);
+					low.set(q2, counter);
+					counter++;
+					sccStack.push(q2);
+					onStack.set(q2);
+					callStack.push(q2);
+					edgeStack.push(0);
+				} else if (onStack[q2])
+					low.set(q, minVal(low[q], index[q2]));
+				continue;
+			}
+
+			callStack.pop();
+			edgeStack.pop();
+			if (!callStack.isEmpty()) {
+				int p = callStack.peek();
+				low.set(p, minVal(low[p], low[q]));
+			}
+			if (low[q] != index[q]) continue;
+
+			// q is the root of a component; pop its members
+			Array<int> members;
+			while (true) {
+				int m = sccStack.pop();
+				onStack.set(m, false);
+				comp.set(m, nComp);
+				members.add(m);
+				if (m == q) break;
+			}
+
+			// the component contains an accepting cycle if it is
+			// non-trivial and contains a state from every accept set
+			bool good = members.length() > 1;
+			if (!good) {
+				for (int i = 0; i < st.trans_.length(); i++)
+					if (st.trans_[i] == q)
+						good = true;
+			}
+			for (int k = 0; good && k < nAcceptSets(); k++) {
+				bool found = false;
+				for (int i = 0; i < members.length(); i++) {
+					if (accepting(members[i], k)) {
+						found = true;
+						break;
+					}
+				}
+				good = found;
+			}
+
+			// if not, it's live only if it leads to a live component
+			for (int i = 0; !good && i < members.length(); i++) {
+				State &sm = states_[members[i]];
+				for (int j = 0; j < sm.trans_.length(); j++) {
+					int q2 = sm.trans_[j];
+					if (!reach[q2]) continue;
+					int c = comp[q2];
+					if (c != nComp && liveComp[c]) {
+						good = true;
+						break;
+					}
+				}
+			}
+
+			p2((" component %d, root %d, %d members, live=%d\n",
+				nComp,q,members.length(),good));
+
+			if (good) {
+				liveComp.set(nComp);
+				for (int i = 0; i < members.length(); i++)
+					live.set(members[i]);
+			}
+			nComp++;
+		}
+	}
+}
@@ -5,6 +5,27 @@
 */
 class Buchi {
 public:
+	Buchi() {
+		cancel_ = 0;
+		dfsVisits_ = 0;
+		labelKind_ = LABEL_NONE;
+		labelVars_ = 0;
+	}
+#if HAS_MOVE
+	Buchi(const Buchi &s) = default;
+	Buchi& operator=(const Buchi &s) = default;
+	Buchi(Buchi &&s) : Buchi() {
+		swap(s);
+	}
+	Buchi& operator=(Buchi &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
+
+	/*	Exchange contents with another automaton, without copying
+	*/
+	void swap(Buchi &s);
 
 	/*	Add a state
 			> initial					if true, makes this an initial state
@@ -32,12 +53,22 @@ public:
 		acceptSets_.add(set);
 	}
 
+	/*	Add a set of accepting states by moving it
+			> set							set to add; it's left empty
+	*/
+	void addAcceptSetMove(BitStore &set) {
+		acceptSets_.addMove(set);
+	}
+
 	/*	Clear automaton to freshly-constructed state
 	*/
 	void clear() {
 		states_.clear();
 		initialStates_.clear();
 		acceptSets_.clear();
+		labelKind_ = LABEL_NONE;
+		labelVars_ = 0;
+		labelLits_.clear();
 	}
 
 	/*	Convert a generalized automaton to a non-generalized one.
@@ -58,21 +89,31 @@ public:
 
 	/*	Convert Kripke model to Buchi automaton
 			> m								Kripke model to convert
-			> v								Prop. Var. table (to determine # vars)
+			> totVars					number of prop. vars in symbol table
 	*/
-	void convertKripke(const Model &m, const Vars &v);
+	void convertKripke(const Model &m, int totVars);
 
 	/*	Calculate the product of two Buchi automata, one which
 			recognizes the intersection of the respective automata.
 			Neither input automata can be generalized.
 			The labels of automata b1 are copied to the first 'row'
 			of the product automaton.
+
+			In general, the product has three copies of each pair of
+			states, to track which automaton's accepting states are to
+			be visited next.  If every state of b1 is accepting, as in
+			an automaton converted from a Kripke model, one copy is
+			enough, and a pair is accepting if its b2 state is.
 			> b1							first buchi
 			> b2							second buchi
 
 	*/
 	void calcProduct(const Buchi &b1, const Buchi &b2);
 
+	/*	Determine if every state is accepting
+	*/
+	bool allAccepting() const;
+
 	/*	Determine if automaton is a generalized automaton
 			< true if it has more than one set of accept states
 	*/
@@ -93,27 +134,98 @@ public:
 	*/
 	bool nonEmpty(Array<int> &sequence);
 
-	/*	Add a label to a state, for display purposes
+	/*	Specify a flag that, when set (possibly by another thread),
+			causes nonEmpty() to abandon its search and return false
+			> flag						pointer to flag, or 0 to disable
+	*/
+	void setCancelFlag(volatile bool *flag) {
+		cancel_ = flag;
+	}
+
+	/*	Determine number of states visited by the last call to nonEmpty()
+	*/
+	int dfsVisits() const {return dfsVisits_;}
+
+	/*	Determine number of transitions
+	*/
+	int nTransitions() const;
+
+	/*	Label a state with the name of the model state it represents
+			(see convertKripke), for display purposes
 			> state						state number
-			> label					
+			> name						name of model state
 	*/
-	void addStateLabel(int state, const String &label) {
-		states_[state].label_.set(label);
+	void setStateName(int state, int name) {
+		labelKind_ = LABEL_NAME;
+		states_[state].label_ = name;
 	}
 
-	const String& stateLabel(int state) const {
-		return states_[state].label_;
+	/*	Get the name of the model state a state represents
+			< name, or -1 if the states aren't labelled with names
+	*/
+	int stateName(int state) const {
+		return labelKind_ == LABEL_NAME ? states_[state].label_ : -1;
 	}
 
-	/*	Set labels of automaton to description of propvar values
+	/*	Get a state's label, for display purposes.  Labels aren't
+			stored; each is constructed when requested, from the model
+			state the state represents, or from the prop. var values of
+			the state it was derived from (see setPropVarLabels).
+			< label, or empty string if state is unlabelled
+	*/
+	String stateLabel(int state) const;
+
+	/*	Label each state with a description of its prop. var values;
+			these labels are inherited by the first 'row' of products
+			> v								symbol table, to describe the variables
+												with; it must outlive the labels
 	*/
 	void setPropVarLabels(Vars &v);
 
-	/*	Reduce automaton by eliminating unreachable states
+	/*	Reduce automaton by eliminating unreachable states, and
+			states that cannot reach a cycle visiting every accept set.
+			If the language is empty, the result has no states.
 			> dest						where to store reduced automaton
 	*/
 	void reduce(Buchi &dest);
+
+	/*	Reduce automaton by merging states that are equivalent under
+			direct simulation, and by removing transitions (and initial
+			states) to states that are simulated by one of their siblings.
+			Also eliminates unreachable states.
+			> dest						where to store reduced automaton
+	*/
+	void simulationReduce(Buchi &dest);
 private:
+	/*	Determine if a state's prop. var. flags are unsatisfiable
+			(some variable must be both true and false)
+	*/
+	bool emptyLabel(int state) const;
+
+	/*	Determine if every assignment satisfying one state's
+			prop. var. flags also satisfies another's
+			> a, b						states
+			> dead						flags of states with empty labels
+			< true if label(a) implies label(b)
+	*/
+	bool labelImplies(int a, int b, const BitStore &dead) const;
+
+	/*	Calculate the direct simulation relation
+			> dead						flags of states with empty labels; these
+												can never be entered, so they are ignored
+												as successors
+			> sim							sim[q] has bit r set if r simulates q
+	*/
+	void calcSimulation(const BitStore &dead, Array<BitStore> &sim) const;
+
+	/*	Find states that can reach a non-trivial strongly connected
+			component containing a state from every accept set
+			> reach						flags of states to consider; transitions
+												to other states are ignored
+			> live						where to store flags of such states
+	*/
+	void findLiveStates(const BitStore &reach, BitStore &live) const;
+
 	/*	Perform emptiness depth-first search, part 1
 			> q								state to start from
 			< true if infinite path found
@@ -135,22 +247,62 @@ private:
 	// true if state is on dfs stack
 	BitStore stacked_;
 
+	bool cancelled() const {
+		return cancel_ != 0 && *cancel_;
+	}
+	// if not 0, flag to abandon emptiness search
+	volatile bool *cancel_;
+	// number of calls to dfs1(), dfs2() by last emptiness search
+	int dfsVisits_;
+
 
 	bool contradiction(int state) const {
 		return contradictionStates_.get(state);
 	}
 
+	/*	Use the same kind of labels as another automaton, whose
+			states' labels are copied to this one's
+	*/
+	void copyLabels(const Buchi &src) {
+		labelKind_ = src.labelKind_;
+		labelVars_ = src.labelVars_;
+		labelLits_ = src.labelLits_;
+	}
+
+	enum {
+		// states aren't labelled
+		LABEL_NONE,
+		// labels are names of model states
+		LABEL_NAME,
+		// labels index prop. var values in labelLits_
+		LABEL_LITS
+	};
+
 	class State {
 	public:
+		State() {
+			label_ = -1;
+		}
+
 		// states this state has transitions to (this embodies '->', the
 		// transition relation)
-		Array<int> trans_;
+		SmallArray<int, 5> trans_;
 
-		// flags indicating which prop. vars must be true (or false)
-		// (if bit is set, indicates it must be true (or false))
-		BitStore pvTrue_, pvFalse_;
+		// prop. vars that must be true (or false)
+		Literals lits_;
 
-		String label_;
+		// name of model state, or index into labelLits_, depending on
+		// labelKind_; -1 if unlabelled
+		int label_;
+
+		void swap(State &s) {
+			trans_.swap(s.trans_);
+			lits_.swap(s.lits_);
+			swapVal(label_, s.label_);
+		}
+		friend void moveValue(State &dest, State &src) {
+			dest.swap(src);
+		}
 	};
 
 	// Q
@@ -165,6 +317,12 @@ private:
 
 	// flags indicating whether a state has contradictions
 	BitStore contradictionStates_;
+
+	// kind of labels the states have (LABEL_xxx)
+	int labelKind_;
+	// for LABEL_LITS: symbol table, and prop. var values to describe
+	Vars *labelVars_;
+	Array<Literals> labelLits_;
 };
 
 #endif // _BUCHI
@@ -2,6 +2,106 @@
 
 void CTLCheck::check(Vars &v, Model &m, Formula &f, BitStore *bs,
 										 bool printFormulas, bool showProgress)
+{
+	begin(v, m, f);
+
+	// label only the states reachable from the initial states, unless
+	// every state is to be displayed
+	restrict_ = !printFormulas && !showProgress;
+	showProgress_ = showProgress;
+
+	finish(bs);
+
+	if (printFormulas && model().defined()) {
+		// print each subformula once, rather than once per state
+		StringArray text;
+		for (int j = 0; j < sfOrder_.length(); j++) {
+			String s;
+			Utils::pushSink(&s);
+			Cout << "  ";
+			f_.print(sfOrder_[j],false);
+			Cout << "\n";
+			Utils::popSink();
+			text.addMove(s);
+		}
+		for (int i = 0; i < model().states(); i++) {
+			int name = model().stateName(i);
+			Cout << "State #" << name << ":\n";
+			for (int j = 0; j < sfOrder_.length(); j++) {
+				if (getFlag(i,sfOrder_[j]))
+					Cout << text[j];
+			}
+			Cout << "\n";
+		}
+	}
+}
+
+void CTLCheck::checkLocal(Vars &v, Model &m, Formula &f, BitStore *bs)
+{
+	begin(v, m, f, true);
+	finish(bs);
+}
+
+void CTLCheck::begin(Vars &v, Model &m, Formula &f, bool local)
+{
+	model_ = &m;
+	vars_ = &v;
+	local_ = local && m.fairnessConstraints() == 0;
+	showProgress_ = false;
+	restrict_ = true;
+	stateFlags_.clear();
+
+	if (!m.defined())
+		return;
+
+	Stats::Timer timer(Stats::PH_CTL);
+	MemAccount acc(MemAccount::CTL);
+	prepare(v, m, f);
+}
+
+void CTLCheck::finish(BitStore *bs)
+{
+	if (bs)
+		bs->clear();
+
+	Model &m = model();
+	if (!m.defined())
+		return;
+
+	Stats::Timer timer(Stats::PH_CTL);
+	MemAccount acc(MemAccount::CTL);
+
+	if (local_) {
+		sfIndex_.clear();
+		for (int i = 0; i < sfOrder_.length(); i++) {
+			int root = sfOrder_[i];
+			sfIndex_.add(i, root);
+			// issue any warnings about variables
+			if (f_.nType(root) == TK_PROPVAR)
+				propVarOf(root);
+		}
+		evalInitialStates();
+	} else {
+		if (Stats::enabled()) {
+			int trans = 0;
+			for (int i = 0; i < m.states(); i++)
+				trans += m.degree(m.stateName(i));
+			Stats &st = Stats::current();
+			st.count(Stats::MODEL_STATES, m.states());
+			st.count(Stats::MODEL_TRANS, trans);
+		}
+
+		prepareModel();
+		findReachable();
+		findFairStates();
+		for (int i = 0; i < sfOrder_.length(); i++)
+			processFormula(sfOrder_[i]);
+	}
+
+	storeResults(bs);
+}
+
+void CTLCheck::prepare(Vars &v, Model &m, Formula &f)
 {
 #undef pt
 #define pt(a) //pr(a)
@@ -11,53 +111,533 @@ void CTLCheck::check(Vars &v, Model &m, Formula &f, BitStore *bs,
 	vars_ = &v;
 
 	sfAlias_.clear();
-	stateFlags_.clear();
 	sfOrder_.clear();
 	pvWarn_.clear();
 
-	showProgress_ = showProgress;
+	ASSERT(f_.isCTL());
 
-	if (bs)
+	// reduce formula to minimal set of connectives
+	f_.reduce();
+	pt(("CTLCheck, checking formula\n    %s\n==> %s\n",f.s(),f_.s()));
+	extractSubformulas();
+
+	// add the formula's variables to the symbol table now, so the
+	// rest of the check only reads it
+	for (int i = 0; i < sfOrder_.length(); i++) {
+		int root = sfOrder_[i];
+		if (f_.nType(root) == TK_PROPVAR)
+			v.var(f_.token(root).text(), true);
+	}
+}
+
+void CTLCheck::evalInitialStates()
+{
+	known_.clear();
+	value_.clear();
+	for (int i = 0; i < sfOrder_.length(); i++) {
+		BitStore store;
+		known_.add(store);
+		value_.add(store);
+	}
+
+	Model &m = model();
+	const OrdSet &is = m.initialStates();
+	for (int i = 0; i < is.length(); i++)
+		demand(sfOrder_.last(), m.stateId(is[i]));
+}
+
+void CTLCheck::storeResults(BitStore *bs)
+{
+#undef pt
+#define pt(a) //pr(a)
+
+	if (bs && local_) {
 		bs->clear();
+		int k = sfOrder_.length() - 1;
+		const OrdSet &is = model().initialStates();
+		for (int i = 0; i < is.length(); i++) {
+			int s = model().stateId(is[i]);
+			if (value_[k][s])
+				bs->set(s);
+		}
+		return;
+	}
 
-	ASSERT(f_.isCTL());
+	if (bs) {
+		bs->clear();
+		int satFormula = sfOrder_.last();
+
+		for (int i = 0; i < model().states(); i++)
+			if (getFlag(i,satFormula))
+				bs->set(i);
+		pt((" satisfying states: %s\n",bs->s() ));
+	}
+}
 
-	prepareModel();
-	if (model().defined()) {
+void CTLCheck::update(const OrdSet &modified, BitStore *bs)
+{
+#undef pt
+#define pt(a) //pr(a)
 
-		// reduce formula to minimal set of connectives
-		f_.reduce();
-		pt(("CTLCheck, checking formula\n    %s\n==> %s\n",f.s(),f_.s()));
-		extractSubformulas();
+	Model &m = model();
+	if (!m.defined() || sfOrder_.isEmpty())
+		return;
 
-		for (int i = 0; i < sfOrder_.length(); i++)
-			processFormula(sfOrder_[i]);
+	Stats::Timer timer(Stats::PH_CTL);
+	MemAccount acc(MemAccount::CTL);
+
+	if (local_) {
+		// any state's values may have changed; start over
+		evalInitialStates();
+		storeResults(bs);
+		return;
+	}
+
+	// add flags for any new states
+	{
+		BitStore store;
+		while (stateFlags_.length() < m.states())
+			stateFlags_.add(store);
+	}
+
+	// progress is only displayed for the original check
+	bool showProgress = showProgress_;
+	showProgress_ = false;
+
+	// states that have become reachable have no values yet, so they
+	// must be evaluated, like those that have changed
+	OrdSet dirty(modified);
+	{
+		BitStore old(reachable_);
+		findReachable();
+		for (int r = 0; r < reach_.length(); r++)
+			if (!old[reach_[r]])
+				dirty.add(reach_[r]);
+
+		// states that are no longer reachable keep no values; if
+		// they become reachable again, they're evaluated afresh
+		for (int s = 0; s < stateFlags_.length(); s++)
+			if (old[s] && !reachable_[s])
+				stateFlags_[s].clear();
+	}
+
+	// any change can affect which states have fair paths, and thus
+	// every subformula involving a path quantifier
+	findFairStates();
+
+	// states whose value changed, for each subformula in sfOrder_
+	Array< Array<int> > sfChanged;
+
+	for (int i = 0; i < sfOrder_.length(); i++) {
+		int root = sfOrder_[i];
+		int type = f_.nType(root);
+
+		// determine which states must be reevaluated: those whose
+		// transitions or prop. vars have changed (this includes new
+		// states, which have no values yet), and those whose
+		// children's values have changed (or for EX, their predecessors)
+
+		Array<int> seeds;
+		BitStore seen;
+
+		for (int j = 0; j < dirty.length(); j++) {
+			int s = dirty[j];
+			seen.set(s);
+			seeds.add(s);
+		}
+
+		for (int c = 0; c < f_.nChildren(root); c++) {
+			int child = childFormula(root,c);
+			int k = 0;
+			while (sfOrder_[k] != child)
+				k++;
+			Array<int> &cc = sfChanged[k];
+			for (int j = 0; j < cc.length(); j++) {
+				int s = cc[j];
+				if (type == TK_EX) {
+					int name = m.stateName(s);
+					for (int n = m.predDegree(name)-1; n >= 0; n--) {
+						int p = m.stateId(m.prev(name,n));
+						if (seen[p]) continue;
+						seen.set(p);
+						seeds.add(p);
+					}
+				} else if (!seen[s]) {
+					seen.set(s);
+					seeds.add(s);
+				}
+			}
+		}
+
+		Array<int> changed;
+		if (type == TK_EG
+			|| (fairness() && (type == TK_AF || type == TK_EU || type == TK_EX))) {
+			recompute(root, changed);
+		} else if (type == TK_AF || type == TK_EU) {
+			updateFixedPoint(root, seeds, changed);
+		} else {
+			for (int j = 0; j < seeds.length(); j++) {
+				int s = seeds[j];
+				bool v = evalLocal(root, s);
+				if (v != getFlag(s,root)) {
+					stateFlags_[s].set(root, v);
+					changed.add(s);
+				}
+			}
+		}
+		pt((" subformula %d, %d seeds, %d changed\n",root,seeds.length(),
+			changed.length()));
+		sfChanged.add(changed);
+	}
+
+	showProgress_ = showProgress;
+	storeResults(bs);
+}
+
+void CTLCheck::recompute(int root, Array<int> &changed)
+{
+	BitStore old;
+	for (int r = 0; r < reach_.length(); r++) {
+		int s = reach_[r];
+		if (getFlag(s,root)) {
+			old.set(s);
+			stateFlags_[s].set(root,false);
+		}
+	}
+
+	processFormula(root);
+
+	for (int r = 0; r < reach_.length(); r++) {
+		int s = reach_[r];
+		if (getFlag(s,root) != old[s])
+			changed.add(s);
+	}
+}
+
+void CTLCheck::findReachable()
+{
+	Model &m = model();
+	reach_.clear();
+	reachable_.clear();
+
+	if (!restrict_) {
+		for (int i = 0; i < m.states(); i++) {
+			reach_.add(i);
+			reachable_.set(i);
+		}
+		return;
+	}
+
+	const OrdSet &is = m.initialStates();
+	for (int i = 0; i < is.length(); i++) {
+		int s = m.stateId(is[i]);
+		if (!reachable_[s]) {
+			reachable_.set(s);
+			reach_.add(s);
+		}
+	}
+
+	// the list is its own queue
+	for (int r = 0; r < reach_.length(); r++) {
+		int name = m.stateName(reach_[r]);
+		for (int j = m.degree(name)-1; j >= 0; j--) {
+			int s = m.stateId(m.next(name,j));
+			if (!reachable_[s]) {
+				reachable_.set(s);
+				reach_.add(s);
+			}
+		}
+	}
+	Stats::current().count(Stats::REACHABLE_STATES, reach_.length());
+}
+
+void CTLCheck::findFairStates()
+{
+	fair_.clear();
+	if (!fairness())
+		return;
+
+	BitStore all;
+	for (int r = 0; r < reach_.length(); r++)
+		all.set(reach_[r]);
+	findFairPaths(all, fair_);
+}
+
+/*	Uses Tarjan's algorithm, iteratively, as in Buchi::findLiveStates.
+		Components of the subgraph are completed in reverse topological
+		order, so when a component is completed, every component it has
+		transitions to has already been classified.  A state has a path
+		if its component is fair (non-trivial, and containing a state
+		satisfying each constraint), or leads to one that has a path.
+*/
+void CTLCheck::findFairPaths(const BitStore &within, BitStore &found)
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	Model &m = model();
+	int n = m.states();
+	found.clear();
+
+	// order in which states were discovered, or -1 if not yet
+	Array<int> index;
+	// lowest index reachable from state through its subtree
+	Array<int> low;
+	// component state belongs to, or -1 if not yet assigned
+	Array<int> comp;
+	index.ensureCapacity(n, false);
+	low.ensureCapacity(n, false);
+	comp.ensureCapacity(n, false);
+	for (int i = 0; i < n; i++) {
+		index.add(-1);
+		low.add(0);
+		comp.add(-1);
+	}
+
+	// flags for components that have a path
+	BitStore goodComp;
+	int nComp = 0;
+	int counter = 0;
+
+	Stack<int> sccStack;
+	BitStore onStack;
+
+	// dfs stack of states, and the next transition to follow from each
+	Stack<int> callStack;
+	Stack<int> edgeStack;
+
+	Array<int> members;
+
+	for (int root = 0; root < n; root++) {
+		if (!within[root] || index[root] >= 0) continue;
+
+		index.set(root, counter);
+		low.set(root, counter);
+		counter++;
+		sccStack.push(root);
+		onStack.set(root);
+		callStack.push(root);
+		edgeStack.push(0);
+
+		while (!callStack.isEmpty()) {
+			int q = callStack.peek();
+			int e = edgeStack.peek();
+			int qName = m.stateName(q);
+
+			if (e < m.degree(qName)) {
+				edgeStack.set(edgeStack.length()-1, e+1);
+				int q2 = m.stateId(m.next(qName,e));
+				if (!within[q2]) continue;
+				if (index[q2] < 0) {
+					index.set(q2, counter);
+					low.set(q2, counter);
+					counter++;
+					sccStack.push(q2);
+					onStack.set(q2);
+					callStack.push(q2);
+					edgeStack.push(0);
+				} else if (onStack[q2])
+					low.set(q, minVal(low[q], index[q2]));
+				continue;
+			}
+
+			callStack.pop();
+			edgeStack.pop();
+			if (!callStack.isEmpty()) {
+				int p = callStack.peek();
+				low.set(p, minVal(low[p], low[q]));
+			}
+			if (low[q] != index[q]) continue;
+
+			// q is the root of a component; pop its members
+			members.clear();
+			while (true) {
+				int s = sccStack.pop();
+				onStack.set(s, false);
+				comp.set(s, nComp);
+				members.add(s);
+				if (s == q) break;
+			}
+
+			// the component contains a fair cycle if it is non-trivial
+			// and contains a state satisfying every constraint
+			bool good = members.length() > 1;
+			if (!good) {
+				for (int j = m.degree(qName)-1; j >= 0; j--)
+					if (m.next(qName,j) == qName)
+						good = true;
+			}
+			for (int k = 0; good && k < m.fairnessConstraints(); k++) {
+				int var = m.fairnessVar(k);
+				bool sat = false;
+				for (int i = 0; i < members.length(); i++) {
+					if (m.propVar(m.stateName(members[i]), var)) {
+						sat = true;
+						break;
+					}
+				}
+				good = sat;
+			}
 
-		if (printFormulas) {
-			for (int i = 0; i < model().states(); i++) {
-				int name = model().stateName(i);
-				Cout << "State #" << name << ":\n";
-				for (int j = 0; j < sfOrder_.length(); j++) {
-					int form = sfOrder_[j];
-					if (getFlag(i,form)) {
-						Cout << "  ";
-						f_.print(form,false);
-						Cout << "\n";
+			// if not, it has a path only if it leads to a component
+			// that has one
+			for (int i = 0; !good && i < members.length(); i++) {
+				int name = m.stateName(members[i]);
+				for (int j = m.degree(name)-1; j >= 0; j--) {
+					int q2 = m.stateId(m.next(name,j));
+					if (!within[q2]) continue;
+					int c = comp[q2];
+					if (c != nComp && goodComp[c]) {
+						good = true;
+						break;
 					}
 				}
-				Cout << "\n";
 			}
+
+			p2((" component %d, root %d, %d members, good=%d\n",
+				nComp,q,members.length(),good));
+
+			if (good) {
+				goodComp.set(nComp);
+				for (int i = 0; i < members.length(); i++)
+					found.set(members[i]);
+			}
+			nComp++;
 		}
+	}
+	Stats::current().count(Stats::FIXPOINT_ITERS);
+}
+
+bool CTLCheck::evalLocal(int root, int state)
+{
+	Model &m = model();
+	int name = m.stateName(state);
+
+	switch (f_.nType(root)) {
+		case TK_PROPVAR:
+			{
+				int var = vars_->var(f_.token(root).str(),true);
+				return m.propVar(name,var);
+			}
+		case TK_NEGATION:
+			return !getFlag(state,childFormula(root,0));
+		case TK_AND:
+			return getFlag(state,childFormula(root,0))
+				&& getFlag(state,childFormula(root,1));
+		case TK_EX:
+			{
+				int c = childFormula(root,0);
+				for (int j = m.degree(name)-1; j >= 0; j--)
+					if (getFlag(m.stateId(m.next(name,j)),c))
+						return true;
+			}
+			break;
+	}
+	return false;
+}
+
+bool CTLCheck::dependsOnSuccessors(int root, int state)
+{
+	if (f_.nType(root) == TK_AF)
+		return !getFlag(state,childFormula(root,0));
+
+	// EU
+	return getFlag(state,childFormula(root,0))
+		&& !getFlag(state,childFormula(root,1));
+}
+
+void CTLCheck::updateFixedPoint(int root, const Array<int> &seeds,
+	Array<int> &changed)
+{
+#undef pt
+#define pt(a) //pr(a)
+
+	Model &m = model();
+	int type = f_.nType(root);
+
+	// find the states whose value may be affected
+	Array<int> region;
+	BitStore inRegion;
+	Stack<int> stk;
 
-		if (bs) {
-			int satFormula = sfOrder_.last();
+	for (int i = 0; i < seeds.length(); i++)
+		stk.push(seeds[i]);
 
-			for (int i = 0; i < model().states(); i++)
-				if (getFlag(i,satFormula))
-					bs->set(i);
-			pt((" satisfying states: %s\n",bs->s() ));
+	while (!stk.isEmpty()) {
+		int s = stk.pop();
+		if (inRegion[s]) continue;
+		inRegion.set(s);
+		region.add(s);
+
+		int name = m.stateName(s);
+		for (int j = m.predDegree(name)-1; j >= 0; j--) {
+			int p = m.stateId(m.prev(name,j));
+			if (!inRegion[p] && dependsOnSuccessors(root,p))
+				stk.push(p);
 		}
 	}
+	pt((" updateFixedPoint root=%d, region size=%d\n",root,region.length()));
+
+	// clear the values within the region, remembering the old ones
+	BitStore old;
+	for (int i = 0; i < region.length(); i++) {
+		int s = region[i];
+		if (getFlag(s,root)) {
+			old.set(s);
+			stateFlags_[s].set(root,false);
+		}
+	}
+
+	// recalculate the least fixed point within the region; the values
+	// of states outside it are unaffected by the changes
+
+	int ca = childFormula(root,0);
+	int cb = (type == TK_EU) ? childFormula(root,1) : -1;
+
+	bool chg = true;
+	while (chg) {
+		Stats::current().count(Stats::FIXPOINT_ITERS);
+		chg = false;
+		for (int i = 0; i < region.length(); i++) {
+			int s = region[i];
+			if (getFlag(s,root)) continue;
+
+			int name = m.stateName(s);
+			bool v;
+			if (type == TK_AF) {
+				v = getFlag(s,ca);
+				if (!v) {
+					v = true;
+					for (int j = m.degree(name)-1; j >= 0; j--) {
+						if (!getFlag(m.stateId(m.next(name,j)),root)) {
+							v = false;
+							break;
+						}
+					}
+				}
+			} else {
+				v = getFlag(s,cb);
+				if (!v && getFlag(s,ca)) {
+					for (int j = m.degree(name)-1; j >= 0; j--) {
+						if (getFlag(m.stateId(m.next(name,j)),root)) {
+							v = true;
+							break;
+						}
+					}
+				}
+			}
+			if (v) {
+				setFlag(s,root);
+				chg = true;
+			}
+		}
+	}
+
+	for (int i = 0; i < region.length(); i++) {
+		int s = region[i];
+		if (getFlag(s,root) != old[s])
+			changed.add(s);
+	}
 }
 
 void CTLCheck::prepareModel()
@@ -68,6 +648,7 @@ void CTLCheck::prepareModel()
 	// initialize state flags to empty
 	{
 		BitStore store;
+		stateFlags_.ensureCapacity(m.states(), false);
 		for (int i = 0; i < m.states(); i++)
 			stateFlags_.add(store);
 	}
@@ -132,6 +713,17 @@ void CTLCheck::markState(int state, int root) {
 	}
 }
 
+int CTLCheck::propVarOf(int root)
+{
+	Token &t = f_.token(root);
+	int var = vars_->var(t.text(),true);
+	if (!model().propVarUsed(var) && !pvWarn_.get(var)) {
+		pvWarn_.set(var);
+		Cout << "Warning: Variable '" << t.str() << "' not used in model\n";
+	}
+	return var;
+}
+
 void CTLCheck::processFormula(int root)
 {
 #undef pt
@@ -140,22 +732,13 @@ void CTLCheck::processFormula(int root)
 	pt(("processFormula root=%d formula=%s\n",root,f_.s(root) ));
 
 	Model &m = model();
-	Token &t = f_.token(root);
 	int type = f_.nType(root);
-	//	pt((" type=%d, str=%s\n",type,Formula::ts(t) ));
-	//pt((" %s\n",Formula::ts(t) ));
 
 	switch (type) {
 		case TK_PROPVAR: {
-			int var = vars_->var(t.str(),true);
-			//int var = Model::varToInt(t.str().charAt(0));
-			if (!m.propVarUsed(var)) {
-				if (!pvWarn_.get(var)) {
-					pvWarn_.set(var);
-					Cout << "Warning: Variable '" << t.str() << "' not used in model\n";
-				}
-			}
-			for (int i = 0; i < m.states(); i++) {
+			int var = propVarOf(root);
+			for (int r = 0; r < reach_.length(); r++) {
+				int i = reach_[r];
 
 				if (m.propVar(m.stateName(i),var)) {
 					//pt((" setting flag %d, %d\n",i,root));
@@ -174,7 +757,8 @@ void CTLCheck::processFormula(int root)
 		case TK_NEGATION:
 			{
 				int child = childFormula(root,0);
-				for (int i = 0; i < m.states(); i++) {
+				for (int r = 0; r < reach_.length(); r++) {
+					int i = reach_[r];
 					if (!getFlag(i,child)) {
 						pt((" flag %d, child %d not set\n",i,child));
 						pt(("     +%d\n",i));
@@ -190,7 +774,8 @@ void CTLCheck::processFormula(int root)
 				int ca = childFormula(root,0),
 					cb = childFormula(root,1);
 
-				for (int i = 0; i < m.states(); i++) {
+				for (int r = 0; r < reach_.length(); r++) {
+					int i = reach_[r];
 					if (getFlag(i,ca) && getFlag(i,cb)) {
 						pt(("     +%d\n",i));
 //						pr(("  +#%2d: %s\n",i,f_.s(root,true)));
@@ -204,11 +789,12 @@ void CTLCheck::processFormula(int root)
 			{
 				int c = childFormula(root,0);
 
-				for (int i = 0; i < m.states(); i++) {
+				for (int r = 0; r < reach_.length(); r++) {
+					int i = reach_[r];
 					int in = m.stateName(i);
 					for (int j = m.degree(in)-1; j >= 0; j--) {
 						int xs = m.next(in,j);
-						if (getFlag(m.stateId(xs),c)) {
+						if (fairFlag(m.stateId(xs),c)) {
 							pt(("     +%d\n",i));
 							markState(i,root);
 //							setFlag(i,root);
@@ -223,10 +809,29 @@ void CTLCheck::processFormula(int root)
 			{
 				int c = childFormula(root,0);
 
+				if (fairness()) {
+					// AF f = !EG !f
+					BitStore notF, eg;
+					for (int r = 0; r < reach_.length(); r++) {
+						int i = reach_[r];
+						if (!getFlag(i,c))
+							notF.set(i);
+					}
+					findFairPaths(notF, eg);
+					for (int r = 0; r < reach_.length(); r++) {
+						int i = reach_[r];
+						if (!eg[i])
+							markState(i,root);
+					}
+					break;
+				}
+
 				bool changed = true;
 				while (changed) {
+					Stats::current().count(Stats::FIXPOINT_ITERS);
 					changed = false;
-					for (int i = 0; i < m.states(); i++) {
+					for (int r = 0; r < reach_.length(); r++) {
+						int i = reach_[r];
 						int iName = m.stateName(i);
 						if (getFlag(i,root)) continue;
 						if (getFlag(i,c)) {
@@ -267,12 +872,14 @@ void CTLCheck::processFormula(int root)
 
 				bool changed = true;
 				while (changed) {
+					Stats::current().count(Stats::FIXPOINT_ITERS);
 					changed = false;
-					for (int i = 0; i < m.states(); i++) {
+					for (int r = 0; r < reach_.length(); r++) {
+						int i = reach_[r];
 						int in = m.stateName(i);
 
 						if (getFlag(i,root)) continue;
-						if (getFlag(i,cb)) {
+						if (fairFlag(i,cb)) {
 							pt(("     +%d (second part true)\n",i));
 							changed = true;
 							markState(i,root);
@@ -298,6 +905,252 @@ void CTLCheck::processFormula(int root)
 				}
 			}
 			break;
+		case TK_EG:
+			{
+				int c = childFormula(root,0);
+
+				BitStore within, eg;
+				for (int r = 0; r < reach_.length(); r++) {
+					int i = reach_[r];
+					if (getFlag(i,c))
+						within.set(i);
+				}
+				findFairPaths(within, eg);
+				for (int r = 0; r < reach_.length(); r++) {
+					int i = reach_[r];
+					if (eg[i])
+						markState(i,root);
+				}
+			}
+			break;
+		}
+}
+
+bool CTLCheck::demand(int root, int state)
+{
+	int k = sfIndex_[root];
+	if (known(k,state))
+		return value_[k][state];
+
+	Model &m = model();
+	int name = m.stateName(state);
+	bool v = false;
+
+	switch (f_.nType(root)) {
+		case TK_PROPVAR:
+			v = m.propVar(name, vars_->var(f_.token(root).text(),true));
+			break;
+		case TK_BOTTOM:
+			break;
+		case TK_NEGATION:
+			v = !demand(childFormula(root,0),state);
+			break;
+		case TK_AND:
+			v = demand(childFormula(root,0),state)
+				&& demand(childFormula(root,1),state);
+			break;
+		case TK_EX:
+			{
+				int c = childFormula(root,0);
+				for (int j = m.degree(name)-1; j >= 0 && !v; j--)
+					v = demand(c, m.stateId(m.next(name,j)));
+			}
+			break;
+		case TK_EU:
+			return demandEU(root, state);
+		case TK_AF:
+		case TK_EG:
+			return demandEG(root, state);
+	}
+	setKnown(k, state, v);
+	return v;
+}
+
+bool CTLCheck::demandEU(int root, int state)
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	Model &m = model();
+	int k = sfIndex_[root];
+	int ca = childFormula(root,0);
+	int cb = childFormula(root,1);
+
+	if (demand(cb,state) || !demand(ca,state)) {
+		bool v = demand(cb,state);
+		setKnown(k, state, v);
+		return v;
+	}
+
+	// states visited by the search, in the order they were
+	// visited; a state's position in this list is its index
+	Array<int> visited;
+	HashMap<int, int> indexOf;
+	// lowest index reachable from state through its subtree
+	Array<int> low;
+	// flags for states (by index) in components not yet completed
+	BitStore onStack;
+	Stack<int> sccStack;
+
+	// dfs stack of states (by index), and the next transition to
+	// follow from each
+	Stack<int> callStack;
+	Stack<int> edgeStack;
+
+	bool found = false;
+
+	indexOf.set(state, 0);
+	visited.add(state);
+	low.add(0);
+	sccStack.push(0);
+	onStack.set(0);
+	callStack.push(0);
+	edgeStack.push(0);
+
+	while (!callStack.isEmpty()) {
+		int qi = callStack.peek();
+		int e = edgeStack.peek();
+		int qName = m.stateName(visited[qi]);
+
+		if (e < m.degree(qName)) {
+			edgeStack.set(edgeStack.length()-1, e+1);
+			int q2 = m.stateId(m.next(qName,e));
+
+			int *ip = indexOf.find(q2);
+			if (ip != 0) {
+				if (onStack[*ip])
+					low.set(qi, minVal(low[qi], *ip));
+				continue;
+			}
+			if (known(k,q2)) {
+				if (value_[k][q2]) {
+					found = true;
+					break;
+				}
+				continue;
+			}
+			if (demand(cb,q2)) {
+				setKnown(k, q2, true);
+				found = true;
+				break;
+			}
+			if (!demand(ca,q2)) {
+				setKnown(k, q2, false);
+				continue;
+			}
+
+			int i2 = visited.length();
+			indexOf.set(q2, i2);
+			visited.add(q2);
+			low.add(i2);
+			sccStack.push(i2);
+			onStack.set(i2);
+			callStack.push(i2);
+			edgeStack.push(0);
+			Stats::current().count(Stats::DFS_STATES);
+			continue;
 		}
+
+		callStack.pop();
+		edgeStack.pop();
+		if (!callStack.isEmpty()) {
+			int pi = callStack.peek();
+			low.set(pi, minVal(low[pi], low[qi]));
+		}
+		if (low[qi] != qi) continue;
+
+		// qi is the root of a component, and every state reachable
+		// from it has been explored without finding one satisfying b
+		while (true) {
+			int si = sccStack.pop();
+			onStack.set(si, false);
+			setKnown(k, visited[si], false);
+			if (si == qi) break;
+		}
+	}
+
+	if (found) {
+		// the states on the search path lead to the one found
+		while (!callStack.isEmpty())
+			setKnown(k, visited[callStack.pop()], true);
+	}
+	p2(("demandEU root=%d state=%d, %d visited, found=%d\n",root,state,
+		visited.length(),found));
+	return value_[k][state];
 }
 
+bool CTLCheck::demandEG(int root, int state)
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	Model &m = model();
+	int k = sfIndex_[root];
+	int c = childFormula(root,0);
+
+	// AF a = !EG !a; the search looks for a path of states where the
+	// child has value 'inside', and such a path makes the subformula
+	// true for EG, false for AF
+	bool af = (f_.nType(root) == TK_AF);
+	bool inside = !af;
+
+	if (demand(c,state) != inside) {
+		setKnown(k, state, af);
+		return af;
+	}
+
+	// dfs stack of states, and the next transition to follow from each
+	Stack<int> callStack;
+	Stack<int> edgeStack;
+	BitStore onStack;
+
+	bool found = false;
+
+	callStack.push(state);
+	edgeStack.push(0);
+	onStack.set(state);
+
+	while (!callStack.isEmpty()) {
+		int q = callStack.peek();
+		int e = edgeStack.peek();
+		int qName = m.stateName(q);
+
+		if (e < m.degree(qName)) {
+			edgeStack.set(edgeStack.length()-1, e+1);
+			int q2 = m.stateId(m.next(qName,e));
+
+			// a cycle, or a state known to lead to one?
+			if (onStack[q2]
+				|| (known(k,q2) && value_[k][q2] != af)) {
+				found = true;
+				break;
+			}
+			if (known(k,q2))
+				continue;
+			if (demand(c,q2) != inside) {
+				setKnown(k, q2, af);
+				continue;
+			}
+			callStack.push(q2);
+			edgeStack.push(0);
+			onStack.set(q2);
+			Stats::current().count(Stats::DFS_STATES);
+			continue;
+		}
+
+		// no successor of q is on the search path, or leads to a cycle,
+		// so q doesn't either
+		callStack.pop();
+		edgeStack.pop();
+		onStack.set(q, false);
+		setKnown(k, q, af);
+	}
+
+	if (found) {
+		// the states on the search path lead to the cycle
+		while (!callStack.isEmpty())
+			setKnown(k, callStack.pop(), !af);
+	}
+	p2(("demandEG root=%d state=%d, found=%d\n",root,state,found));
+	return value_[k][state];
+}
@@ -2,6 +2,18 @@
 #define _CTLCHECK
 
 /*	CTL Model Checking class
+
+		Formulas are reduced to the connectives !, &, EX, EU, AF and EG.
+		If the model has fairness constraints, path quantifiers range
+		over fair paths only (those that satisfy every constraint
+		infinitely often):
+
+			EX f     = EX (f & fair)
+			E[f U g] = E[f U (g & fair)]
+			EG f     = states with a fair path along which f always holds
+			AF f     = !EG !f
+
+		where fair = EG true.
 */
 
 class CTLCheck {
@@ -19,8 +31,52 @@ public:
 	void check(Vars &vars, Model &model, Formula &f, BitStore *bs = 0,
 		bool printFormulas = false, bool showProgress = false);
 
+	/*	Check a formula in the initial states only.  Subformulas are
+			evaluated on demand, searching outward from the initial
+			states, so only the states needed to decide the result are
+			explored.  If the model has fairness constraints, every
+			state is checked, as in check().
+			> vars						symbol table
+			> model						model to check
+			> f								specification (CTL formula)
+			> bs							if not 0, where to store flags representing
+													satisfying start states
+	*/
+	void checkLocal(Vars &vars, Model &model, Formula &f, BitStore *bs = 0);
+
+	/*	Begin checking a formula, without displaying anything: reduce
+			it, and extract its subformulas.  This modifies the formula
+			forest and the symbol table, so it must be done by the thread
+			that owns them; finish() only reads them, so different
+			checks can be finished concurrently.
+			> vars						symbol table
+			> model						model to check
+			> f								specification (CTL formula)
+			> local						if true, checks the initial states only,
+													as in checkLocal()
+	*/
+	void begin(Vars &vars, Model &model, Formula &f, bool local = false);
+
+	/*	Finish a check started by begin()
+			> bs							if not 0, where to store flags representing
+													satisfying start states
+	*/
+	void finish(BitStore *bs = 0);
+
+	/*	Update the results of the last check after the model has
+			been changed.  Subformulas are only reevaluated in states
+			whose value could have been affected by the changes.
+			> changed					ids of states whose transitions or prop. vars
+												have changed, or that have been added
+			> bs							if not 0, where to store flags representing
+													satisfying states
+	*/
+	void update(const OrdSet &changed, BitStore *bs = 0);
+
 	CTLCheck() {
 		showProgress_ = false;
+		local_ = false;
+		restrict_ = false;
 	}
 
 #if DEBUG
@@ -31,10 +87,20 @@ private:
 
 	Model &model() {return *model_;}
 
+	/*	Prepare to check a formula: reduce it, and extract its
+			subformulas
+	*/
+	void prepare(Vars &vars, Model &model, Formula &f);
+
 	/*	Prepare model for checking
 	*/
 	void prepareModel();
 
+	/*	Get the variable of a prop. var subformula, warning (once) if
+			it isn't used in the model
+	*/
+	int propVarOf(int root);
+
 	void processFormula(int root);
 
 	/*	Extract list of subformulas from the formula
@@ -69,6 +135,108 @@ private:
 	*/
 	int childFormula(int node, int child);
 
+	/*	Evaluate a subformula that isn't a fixed point (AF, EU) in
+			a state, from the values of its children
+			> root						subformula
+			> state						id of state
+			< true if state satisfies subformula
+	*/
+	bool evalLocal(int root, int state);
+
+	/*	Reevaluate a fixed point subformula (AF, EU) after changes to
+			the model or to its children's values.  Only states that can
+			reach a changed state through states whose value depends
+			on their successors are reevaluated.
+			> root						subformula
+			> seeds						ids of states that have changed
+			> changed					ids of states whose value changed are
+												added to this
+	*/
+	void updateFixedPoint(int root, const Array<int> &seeds, Array<int> &changed);
+
+	/*	Determine if a state's value for a fixed point subformula
+			depends on the values of its successors
+	*/
+	bool dependsOnSuccessors(int root, int state);
+
+	/*	Reevaluate a subformula in every state
+			> root						subformula
+			> changed					ids of states whose value changed are
+												added to this
+	*/
+	void recompute(int root, Array<int> &changed);
+
+	/*	Determine if the model has fairness constraints
+	*/
+	bool fairness() const {return model_->fairnessConstraints() > 0;}
+
+	/*	Read flag for state, treating it as false if there is no
+			fair path from the state
+			> state						id of state
+			> fi							bit to read
+	*/
+	bool fairFlag(int state, int fi) {
+		return getFlag(state,fi) && (!fairness() || fair_[state]);
+	}
+
+	/*	Find the states that have a path staying within a set of
+			states forever and, if the model has fairness constraints,
+			satisfying each of them infinitely often
+			> within					ids of states the path must stay within
+			> found						where to store ids of states found
+	*/
+	void findFairPaths(const BitStore &within, BitStore &found);
+
+	/*	Determine the states to be labelled: those reachable from the
+			initial states, or every state if restrict_ is false
+	*/
+	void findReachable();
+
+	/*	Determine the states that have fair paths from them
+	*/
+	void findFairStates();
+
+	/*	Evaluate the formula in the initial states, on demand
+	*/
+	void evalInitialStates();
+
+	/*	Determine if a state satisfies a subformula, evaluating it
+			(and the subformulas it depends on, in the states required)
+			if it hasn't been already
+			> root						subformula
+			> state						id of state
+	*/
+	bool demand(int root, int state);
+
+	/*	Evaluate E[a U b] in a state, by searching forward from it
+			through states satisfying a for one satisfying b.  The
+			states of each strongly connected component that is
+			completely explored without finding one don't satisfy it.
+	*/
+	bool demandEU(int root, int state);
+
+	/*	Evaluate EG a, or AF a (as !EG !a), in a state, by searching
+			forward from it for a cycle of states satisfying a (or !a)
+	*/
+	bool demandEG(int root, int state);
+
+	/*	Determine if the value of a subformula is known in a state
+			> k								index of subformula in sfOrder_
+	*/
+	bool known(int k, int state) const {return known_[k][state];}
+
+	/*	Store the value of a subformula in a state
+			> k								index of subformula in sfOrder_
+	*/
+	void setKnown(int k, int state, bool value) {
+		known_[k].set(state);
+		value_[k].set(state, value);
+	}
+
+	/*	Store flags for states satisfying the formula
+	*/
+	void storeResults(BitStore *bs);
+
 	// specification being checked, in reduced form
 	Formula f_;
 
@@ -85,6 +253,19 @@ private:
 	// flags for each state in model
 	Array<BitStore> stateFlags_;
 
+	// flags for states with fair paths from them, if model has
+	// fairness constraints
+	BitStore fair_;
+
+	// true if only the states reachable from the initial states are
+	// labelled
+	bool restrict_;
+
+	// ids of states being labelled, and flags for them; other states
+	// have no subformulas marked
+	Array<int> reach_;
+	BitStore reachable_;
+
 	// flags indicating which vars we've printed warnings about
 	BitStore pvWarn_;
 
@@ -93,6 +274,18 @@ private:
 
 	// true if we're to display formulas as they're marked in states
 	bool showProgress_;
+
+	// true if formulas are evaluated on demand, in the initial states
+	bool local_;
+
+	// for evaluating on demand: for each subformula (indexed as
+	// in sfOrder_), flags for states whose values are known, and
+	// their values
+	Array<BitStore> known_;
+	Array<BitStore> value_;
+
+	// index of each subformula in sfOrder_, by node
+	Array<int> sfIndex_;
 };
 
 #endif // _CTLCHECK
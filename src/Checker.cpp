@@ -0,0 +1,187 @@
+#include "globals.h"
+
+// DFA for recognizing tokens, from the internal table
+extern unsigned char _dfa[];
+
+void CheckResult::clear()
+{
+	text.clear();
+	ctl = false;
+	satisfied = false;
+	states.clear();
+	path.clear();
+	loop = -1;
+	messages.clear();
+}
+
+void CompareResult::clear()
+{
+	equivalent = false;
+	for (int i = 0; i < 2; i++) {
+		text[i].clear();
+		allows[i].clear();
+		loop[i] = -1;
+	}
+}
+
+Checker::Checker()
+: model_(context_.vars())
+{
+	ByteBufferReader rd(_dfa);
+	dfa_.read(rd);
+}
+
+void Checker::open(Scanner &scan, StringReader &rd, const char *text,
+	int len)
+{
+	scan.setSkip(TK_WS);
+	rd.begin(String(text, 0, len));
+	String name("text");
+	scan.includeSource(rd, &name);
+}
+
+void Checker::parseFormula(Scanner &scan, Formula &f)
+{
+	{
+		Stats::Timer timer(Stats::PH_PARSE);
+		MemAccount acc(MemAccount::FORMULA);
+		f.parse(scan);
+	}
+	Token t;
+	if (scan.peek(t))
+		throw ParseException("Unexpected text following formula");
+}
+
+String Checker::textOf(Formula &f)
+{
+	String text;
+	Utils::pushSink(&text);
+	f.print(-1,false);
+	Utils::popSink();
+	return text;
+}
+
+void Checker::loadModel(const char *text, int len)
+{
+	Context::Use use(context_);
+	Stats::Use useStats(stats_);
+	MemAccount::Check check;
+
+	model_.clear();
+	context_.vars().clear();
+
+	Scanner scan(0,&dfa_);
+	StringReader rd;
+	open(scan, rd, text, len);
+	try {
+		Stats::Timer timer(Stats::PH_PARSE);
+		MemAccount acc(MemAccount::MODEL);
+		model_.parse(scan);
+		Token t;
+		if (scan.peek(t))
+			throw ParseException("Unexpected text following model");
+	} catch (Exception &e) {
+		// don't leave a partial model behind
+		model_.clear();
+		throw;
+	}
+}
+
+bool Checker::check(const char *text, int len, CheckResult &r)
+{
+	Context::Use use(context_);
+	Stats::Use useStats(stats_);
+	MemAccount::Check check;
+
+	r.clear();
+	if (!model_.defined())
+		throw ParseException("No model to check");
+
+	Scanner scan(0,&dfa_);
+	StringReader rd;
+	open(scan, rd, text, len);
+
+	// anything the check prints (such as warnings) is collected in
+	// the result, rather than being displayed
+	Utils::pushSink(&r.messages);
+	try {
+		Formula f;
+		parseFormula(scan, f);
+		r.text = textOf(f);
+		r.ctl = f.isCTL();
+
+		if (r.ctl) {
+			CTLCheck c;
+			c.check(context_.vars(), model_, f, &r.states);
+
+			r.satisfied = true;
+			const OrdSet &is = model_.initialStates();
+			for (int i = 0; i < is.length(); i++)
+				if (!r.states.get(model_.stateId(is[i])))
+					r.satisfied = false;
+		} else {
+			if (!f.isLTL())
+				throw ParseException("Cannot check mixed CTL/LTL formula");
+
+			// the check's report is discarded; only its warnings are kept
+			String report;
+			Utils::pushSink(&report);
+			LTLCheck c(context_.vars());
+			try {
+				r.satisfied = c.check(model_, f);
+			} catch (Exception &e) {
+				Utils::popSink();
+				throw;
+			}
+			Utils::popSink();
+			r.path = c.counterexample(r.loop);
+		}
+	} catch (Exception &e) {
+		Utils::popSink();
+		Formula::forest().reclaim();
+		throw;
+	}
+	Utils::popSink();
+	Formula::forest().reclaim();
+	return r.satisfied;
+}
+
+bool Checker::compare(const char *text1, int len1, const char *text2,
+	int len2, CompareResult &r)
+{
+	Context::Use use(context_);
+	Stats::Use useStats(stats_);
+	MemAccount::Check check;
+
+	r.clear();
+
+	// the comparison's report is discarded
+	String report;
+	Utils::pushSink(&report);
+	try {
+		Formula f[2];
+		const char *text[2] = {text1, text2};
+		int len[2] = {len1, len2};
+		for (int i = 0; i < 2; i++) {
+			Scanner scan(0,&dfa_);
+			StringReader rd;
+			open(scan, rd, text[i], len[i]);
+			parseFormula(scan, f[i]);
+			r.text[i] = textOf(f[i]);
+			if (!f[i].isLTL())
+				throw ParseException("Not an LTL formula");
+		}
+
+		LTLCheck c(context_.vars());
+		r.equivalent = c.compare(f[0], f[1]);
+		for (int i = 0; i < 2; i++)
+			r.allows[i] = c.difference(i, r.loop[i]);
+	} catch (Exception &e) {
+		Utils::popSink();
+		Formula::forest().reclaim();
+		throw;
+	}
+	Utils::popSink();
+	Formula::forest().reclaim();
+	return r.equivalent;
+}
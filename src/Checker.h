@@ -0,0 +1,144 @@
+#ifndef _CHECKER
+#define _CHECKER
+
+/*	Result of checking a formula with a Checker
+*/
+class CheckResult {
+public:
+	CheckResult() {
+		clear();
+	}
+	void clear();
+
+	// formula, as printed
+	String text;
+	// true if checked as a CTL formula, false for LTL
+	bool ctl;
+	// true if every initial state satisfies the formula
+	bool satisfied;
+	// CTL: flags of the states satisfying the formula, by id (see
+	// Model::stateId); only states reachable from the initial
+	// states are included
+	BitStore states;
+	// LTL: if not satisfied, a counterexample, as the names of the
+	// model's states along it; it repeats forever from index loop
+	Array<int> path;
+	int loop;
+	// warnings issued by the check
+	String messages;
+};
+
+/*	Result of comparing two LTL formulas with a Checker
+*/
+class CompareResult {
+public:
+	CompareResult() {
+		clear();
+	}
+	void clear();
+
+	// formulas, as printed
+	String text[2];
+	bool equivalent;
+	// for each formula, a sequence it allows but the other doesn't
+	// (empty if there is none), as descriptions of the prop. var
+	// values in each step; it repeats forever from index loop
+	StringArray allows[2];
+	int loop[2];
+};
+
+/*	Model checker for programs that link with the checker, rather
+		than running it and reading its output.  A model is loaded from
+		text in memory, then formulas are checked against it, and the
+		results are returned as values:
+
+			Checker c;
+			c.loadModel(modelText, modelLen);
+			CheckResult r;
+			c.check("AG EF p", 7, r);
+
+		Nothing is printed.  Errors in the text, and exceeding the memory
+		budget, are thrown as Exceptions.
+
+		Each checker has its own context (see Context), DFA and
+		statistics (see Stats), and each of its operations is a
+		separate memory check (see MemAccount::Check), so different
+		threads can use different checkers; a checker can't be used by
+		more than one thread at once.  The memory budget
+		(MemAccount::setBudget) and whether statistics are collected
+		(Stats::enable) are settings of the process, and should be
+		made before any checker is used.
+*/
+class Checker {
+public:
+	Checker();
+
+	/*	Load a model, replacing the current one
+			> text						model, in the usual syntax ('{ ... }')
+			> len							length of text
+	*/
+	void loadModel(const char *text, int len);
+
+	/*	Check a formula against the model
+			> text						CTL or LTL formula
+			> len							length of text
+			> r								where to store the result
+			< true if every initial state satisfies the formula
+	*/
+	bool check(const char *text, int len, CheckResult &r);
+
+	/*	Compare two LTL formulas; no model is required
+			> text1						first formula
+			> len1						length of first formula
+			> text2						second formula
+			> len2						length of second formula
+			> r								where to store the result
+			< true if equivalent
+	*/
+	bool compare(const char *text1, int len1, const char *text2, int len2,
+		CompareResult &r);
+
+	/*	Get the current model; the ids in a CheckResult's states can
+			be converted to names with its stateName()
+	*/
+	const Model &model() const {return model_;}
+
+	/*	Determine if a model has been loaded
+	*/
+	bool defined() {return model_.defined();}
+
+	/*	Get the statistics accumulated by the checker's operations,
+			if collection is enabled (see Stats)
+	*/
+	const Stats &stats() const {return stats_;}
+
+private:
+	// no copying allowed
+	Checker(const Checker &s);
+	Checker& operator=(const Checker &s);
+
+	/*	Prepare a scanner to read text
+			> scan						scanner
+			> rd							reader to store text in
+			> text						text to read
+			> len							length of text
+	*/
+	void open(Scanner &scan, StringReader &rd, const char *text, int len);
+
+	/*	Parse a formula, which must be all that remains of the text
+	*/
+	void parseFormula(Scanner &scan, Formula &f);
+
+	/*	Get formula as printed
+	*/
+	static String textOf(Formula &f);
+
+	Context context_;
+	DFA dfa_;
+	Model model_;
+	// statistics of the checker's operations; each checker has its
+	// own, so they aren't shared with other threads
+	Stats stats_;
+};
+
+#endif // _CHECKER
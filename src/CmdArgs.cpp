@@ -89,6 +89,15 @@ void CmdArgs::addArguments(int argc, const char **argv, bool includesExe) {
 	for (int i = 0; i < argc; i++) {
 		const char *s = argv[i];
 
+		// is it a long option?
+		if ((!includesExe || i > 0)
+			&& isLongOption(s)
+			) {
+				pt(("Adding long option '%s'\n",s));
+				strings_.add(s);
+				continue;
+		}
+
 		// is it an option?  
 		if ((!includesExe || i > 0)
 			&& isOption(s)
@@ -140,6 +149,20 @@ bool CmdArgs::peekOption(char c)
 	return false;
 }
 
+bool CmdArgs::peekOption(const char *name)
+{
+	if (hasNext()) {
+		String &s = strings_.itemAt(argNumber_);
+		if (isLongOption(s)
+			&& s.subStr(2).equals(name)) {
+				pt(("Peeked at option --%s\n",name));
+				argNumber_++;
+				return true;
+			}
+	}
+	return false;
+}
+
 bool CmdArgs::nextIsValue() const {
 	return (hasNext() && !isOption(strings_.itemAt(argNumber_)));
 }
@@ -48,6 +48,10 @@ public:
 	// read the next argument if it matches a particular option;
 	// if there are no more, or it's not a match, return false
 	bool peekOption(char c);
+	// read the next argument if it matches a particular long
+	// option (e.g. "stats" for --stats); if there are no more, or
+	// it's not a match, return false
+	bool peekOption(const char *name);
 
 	// parse next argument as integer
 	int nextInt() {return Utils::parseInt(nextValue()); }
@@ -70,7 +74,12 @@ public:
 #endif
 private:
 	static bool isOption(const String &s) {
-		return (s.length() >= 2 && s.charAt(0) == '-' && Utils::isAlpha(s.charAt(1),false));
+		return (s.length() >= 2 && s.charAt(0) == '-' && Utils::isAlpha(s.charAt(1),false))
+			|| isLongOption(s);
+	}
+	static bool isLongOption(const String &s) {
+		return (s.length() >= 3 && s.charAt(0) == '-' && s.charAt(1) == '-'
+			&& Utils::isAlpha(s.charAt(2),false));
 	}
 	void addArguments(int argc, const char **argv, bool includesExe = false);
 	Array<String> strings_;
@@ -0,0 +1,8 @@
+#include "globals.h"
+
+THREAD_LOCAL Context *Context::current_;
+
+Context::Context()
+{
+	forest_.setCallback(Formula::cbFunc);
+}
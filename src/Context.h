@@ -0,0 +1,71 @@
+#ifndef _CONTEXT
+#define _CONTEXT
+
+/*	Checking context: the forest containing formulas, the tokens of
+		its nodes, and the symbol table for prop. variables.  Formulas
+		and the objects built from them (models, checkers, automata)
+		belong to one context, and are used only by threads that make
+		it current:
+
+			Context ctx;
+			{
+				Context::Use use(ctx);
+				... formulas constructed and used here belong to ctx ...
+			}
+
+		Several threads can check formulas independently, without
+		locking, as long as each uses its own context.  Threads that
+		share one (see Session) must not modify it concurrently.  Each
+		thread also has its own active sink (see Utils::pushSink).
+		A DFA is not part of a context, but records the state of the
+		token it's recognizing, so each thread needs its own.  The
+		memory budget applies to each check (see MemAccount::Check),
+		not to each context.
+
+		A context must outlive the objects belonging to it.
+*/
+class Context {
+public:
+	Context();
+
+	Forest &forest() {return forest_;}
+	SArray<Token> &tokens() {return tokens_;}
+	Vars &vars() {return vars_;}
+
+	/*	Get this thread's current context
+	*/
+	static Context &current() {
+		ASSERT(current_ != 0);
+		return *current_;
+	}
+
+	/*	Makes a context current for this thread until destroyed
+	*/
+	class Use {
+	public:
+		Use(Context &c) {
+			prev_ = current_;
+			current_ = &c;
+		}
+		~Use() {
+			current_ = prev_;
+		}
+	private:
+		Context *prev_;
+	};
+
+private:
+	// no copying allowed
+	Context(const Context &s);
+	Context& operator=(const Context &s);
+
+	// tokens of the forest's nodes; a node's token is released when
+	// the forest deletes the node
+	SArray<Token> tokens_;
+	Forest forest_;
+	Vars vars_;
+
+	static THREAD_LOCAL Context *current_;
+};
+
+#endif // _CONTEXT
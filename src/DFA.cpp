@@ -22,9 +22,9 @@
 #include "DFA.h"
 #include "Scanner.h"
 
-int DFA::recognize(const String &str, int startPos, int &length) {
+int DFA::recognize(const char *chars, int len, int startPos, int &length) {
 
-	ASSERT(startPos <= str.length());
+	ASSERT(startPos <= len);
 
 	// keep track of the length of the longest token found, and
 	// the final state it's associated with
@@ -35,9 +35,9 @@ int DFA::recognize(const String &str, int startPos, int &length) {
 	setState(startState_);
 	int i = startPos;
 
-	while (i < str.length()) {
+	while (i < len) {
 
-		char c = str.charAt(i);
+		char c = chars[i];
 
 		// if this is not a legal character for a token, no match.
 		if (!isValid(c))
@@ -68,7 +68,19 @@ public:
 												or 0 if none recognized
 			< id of token recognized, or -1 if none
 	*/
-	int recognize(const String &str, int startPos, int &length);
+	int recognize(const String &str, int startPos, int &length) {
+		return recognize(str.chars(), str.length(), startPos, length);
+	}
+
+	/*	Attempt to recognize a token from a sequence of characters
+			> chars						characters being scanned
+			> len							number of characters
+			> startPos				start position within them
+			< length					length of recognized token is stored here,
+												or 0 if none recognized
+			< id of token recognized, or -1 if none
+	*/
+	int recognize(const char *chars, int len, int startPos, int &length);
 
 	/*	Make a particular state a final state.  Creates
 			it if it doesn't exist.
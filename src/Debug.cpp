@@ -411,6 +411,7 @@ void Debug::myAssert(const char *file, int line, bool flag, const char *msg,
 
 		pr(("....assertion failure....\n"));
 		if (exitIfFail) {
+			Utils::flushOutput();
 			cout << "*** Critical assertion failure (" << file << ": " << line << ") "
 				 << msg << "\n";
 			exit(1);
@@ -112,8 +112,6 @@ void My_printf(const char *fmt, ...);
 // are generating 'unreferenced' warnings
 #define REF(a) {void *unused = &(a);}
 class Sink;
-// global pointer to active stream (0 if none)
-extern Sink *activeSink;
 #define Cout Utils::getActiveSink()
 
 #include "Memory.h"
@@ -68,3 +68,13 @@ public:	StringFormatException(const String &msg) : Exception(msg) {}
 class AssertException : public Exception {
 public:	AssertException(const String &msg) : Exception(msg) {}
 };
+
+class MemoryException : public Exception {
+public:	MemoryException(const String &msg) : Exception(msg) {}
+};
+
+// error that occurred while checking formulas that had already been
+// read, so it isn't associated with the current position in the input
+class CheckException : public Exception {
+public:	CheckException(const String &msg) : Exception(msg) {}
+};
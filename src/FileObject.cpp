@@ -1,6 +1,13 @@
 #include "Headers.h"
 #include "Files.h"
 
+#if UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 void FileObject::writeString(const String &str, const String &path) {
 	TextWriter w(path);
 	w << str;
@@ -71,6 +78,10 @@ void FileObject::setError(const char *msg)
 }
 
 Source &InputStreamWrapper::operator >>(String &s) {
+	// if the stream is tied to an output stream (as standard input is
+	// to standard output), send any prompts or results first
+	if (s_.tie() != 0)
+		Utils::flushOutput();
 	s.clear();
 	while (true) {
 		char c;
@@ -81,3 +92,105 @@ Source &InputStreamWrapper::operator >>(String &s) {
 	return *this;
 }
 
+
+Sink& BufferedSink::operator << (int i)
+{
+	if (used_ > SIZE - 12)
+		flush();
+	used_ += Utils::intToStr(i, buffer_ + used_);
+	return *this;
+}
+
+Sink& BufferedSink::operator << (double d)
+{
+	if (used_ > SIZE - 40)
+		flush();
+	used_ += sprintf(buffer_ + used_, "%g", d);
+	return *this;
+}
+
+void BufferedSink::write(const char *s, int len)
+{
+	if (len > SIZE - used_) {
+		flush();
+		// write large blocks directly, rather than through the buffer
+		if (len > SIZE / 2) {
+			fwrite(s, 1, len, f_);
+			return;
+		}
+	}
+	memcpy(buffer_ + used_, s, len);
+	used_ += len;
+}
+
+void BufferedSink::flush()
+{
+	if (used_ > 0) {
+		fwrite(buffer_, 1, used_, f_);
+		used_ = 0;
+	}
+	fflush(f_);
+}
+
+void MappedFile::open(const String &path)
+{
+	close();
+	path_ = path;
+
+	String path2(path);
+	path2.path_toSystem();
+
+	String msg("Opening file, ");
+	msg << path;
+
+#if UNIX
+	int fd = ::open(path2.chars(), O_RDONLY);
+	if (fd < 0)
+		throw IOException(msg);
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size > INT_MAX) {
+		::close(fd);
+		throw IOException(msg);
+	}
+	length_ = (int)st.st_size;
+	if (length_ > 0) {
+		void *p = mmap(0, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			data_ = (const char *)p;
+			mapped_ = true;
+		}
+	}
+	::close(fd);
+	if (mapped_ || length_ == 0) {
+		if (length_ == 0)
+			data_ = "";
+		return;
+	}
+#endif
+
+	// read the file to a buffer instead
+	fstream f(path2.chars(), fstream::in | fstream::binary);
+	if (f.fail())
+		throw IOException(msg);
+	f.seekg(0, ios::end);
+	length_ = (int)f.tellg();
+	f.seekg(0, ios::beg);
+	NewArray(buffer_, length_ + 1);
+	f.read(buffer_, length_);
+	length_ = (int)f.gcount();
+	data_ = buffer_;
+}
+
+void MappedFile::close()
+{
+#if UNIX
+	if (mapped_)
+		munmap(const_cast<char *>(data_), length_);
+#endif
+	if (buffer_ != 0)
+		DeleteArray(buffer_);
+	buffer_ = 0;
+	data_ = 0;
+	length_ = 0;
+	mapped_ = false;
+}
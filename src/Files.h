@@ -106,6 +106,47 @@ protected:
 	int lineNumber_;
 };
 
+/*	MappedFile: makes the contents of a file available in memory, by
+		mapping it into the address space where possible, so the file can
+		be read without copying it
+*/
+class MappedFile {
+public:
+	MappedFile() {
+		data_ = 0;
+		length_ = 0;
+		mapped_ = false;
+		buffer_ = 0;
+	}
+	~MappedFile() {close();}
+
+	/*	Open a file; throws IOException if it can't be read
+			> path						path of file
+	*/
+	void open(const String &path);
+	void close();
+
+	/*	Get the file's contents
+	*/
+	const char *chars() const {return data_;}
+	int length() const {return length_;}
+
+	String &path() {return path_;}
+
+private:
+	// no copying allowed
+	MappedFile(const MappedFile &s);
+	MappedFile& operator=(const MappedFile &s);
+
+	String path_;
+	const char *data_;
+	int length_;
+	// true if data_ is a mapping
+	bool mapped_;
+	// buffer file was read to, if it couldn't be mapped
+	char *buffer_;
+};
+
 #if DEBUG
 void Test_TextReader();
 void Test_TextWriter();
@@ -237,7 +278,7 @@ public:
 	virtual Source& operator >> (char &c);
 	virtual Source& operator >> (double &d);
 	virtual Source& operator >> (float &f);
-	virtual bool eof() {return !reading_ || cursor_ == str_.length();}
+	virtual bool eof() {return !reading_ || cursor_ == length_;}
 
 #if DEBUG
 	String debInfo();
@@ -261,6 +302,15 @@ public:
 	*/
 	void begin(const String &str, int startPos = 0);
 
+	/*	Start tokenizing a sequence of characters, without copying them;
+			they must remain unchanged while they're being read
+
+			> chars						characters to tokenize
+			> len							number of characters
+			> startPos				position within them to start at
+	*/
+	void begin(const char *chars, int len, int startPos = 0);
+
 	/*	Determine if tokenizer is in the reading state	*/
 	bool reading() const {return reading_;}
 
@@ -330,11 +380,13 @@ public:
 	*/
 	int cursor() const {return cursor_; }
 
-	//	Return a (read-only) reference to the string being read
-	const String &str() const {
+	/*	Get the characters being read
+	*/
+	const char *chars() const {
 		ASSERT(reading());
-		return str_;
+		return text_;
 	}
+	int length() const {return length_;}
 
 	/*	Return an array of words (Strings) extracted from a string.
 			> s								string to extract from
@@ -353,8 +405,11 @@ protected:
 	void updatePrevLen(int len) { prevLen_ = len; }
 	virtual void construct();
 
-	// string being read
-  String str_;
+	// copy of string being read, if begun with a String
+	String str_;
+	// characters being read, and their number
+	const char *text_;
+	int length_;
 	bool reading_;
 	int cursor_;
 };
@@ -498,6 +553,52 @@ private:
 	ostream &s_;
 };
 
+/*	Sink that writes to a stdio stream through a buffer of its own.
+		Strings are copied into the buffer in bulk, and numbers are
+		formatted directly into it, so writing allocates no memory.
+*/
+class BufferedSink : public Sink {
+public:
+	BufferedSink(FILE *f) : f_(f), used_(0) {}
+	virtual ~BufferedSink() {flush();}
+
+	// sink interface:
+	virtual Sink& operator << (const char *s) {
+		write(s, stringLength(s));
+		return *this;
+	}
+	virtual Sink& operator << (const String &s) {
+		write(s.chars(), s.length());
+		return *this;
+	}
+	virtual Sink& operator << (int i);
+	virtual Sink& operator << (short i) {return *this << (int)i;}
+	virtual Sink& operator << (char c) {
+		if (used_ == SIZE)
+			flush();
+		buffer_[used_++] = c;
+		return *this;
+	}
+	virtual Sink& operator << (double d);
+	virtual Sink& operator << (float f) {return *this << (double)f;}
+	virtual void write(const char *s, int len);
+	virtual void flush();
+
+private:
+	// no copying allowed
+	BufferedSink(const BufferedSink &s);
+	BufferedSink& operator=(const BufferedSink &s);
+
+	enum {
+		SIZE = 1 << 16
+	};
+
+	FILE *f_;
+	// number of characters in buffer
+	int used_;
+	char buffer_[SIZE];
+};
+
 class InputStreamWrapper : public Source {
 public:
 	InputStreamWrapper(istream &s) : s_(s) {}
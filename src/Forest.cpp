@@ -6,12 +6,18 @@ Forest::Forest() {
 		|GFLAG_ALLOWLOOPS
 		|GFLAG_MULTIGRAPH
 		);
+	nodesInUse_ = 0;
+	cbFunc_ = 0;
 }
 
 int Forest::newNode()
 {
 	int n = graph_.newNode();
 	nodesUsed_.set(n);
+	nodesInUse_++;
+	refs_.add(0, n);
+	// until it's attached to something, it's unreferenced
+	unreferenced_.add(n);
 	return n;
 }
 
@@ -19,6 +25,10 @@ void Forest::clear() {
 	trees_.clear();
 	treesRB_.clear();
 	graph_.clear();
+	nodesUsed_.clear();
+	nodesInUse_ = 0;
+	refs_.clear();
+	unreferenced_.clear();
 }
 
 #if DEBUG
@@ -130,7 +140,9 @@ void Forest::deleteChild(int parent, int position)
 #define p2(a) //pr(a)
 
 	p2(("deleteChild parent=%d position=%d child=%d\n",parent,position,child(parent,position)));
+	int c = child(parent,position);
 	graph_.deleteEdge(parent,position);
+	unref(c);
 //	int c = child(parent,position);
 //	Node &n = graph_.node(parent);
 //	int child = n.edgeDest(position);
@@ -144,6 +156,7 @@ void Forest::deleteTree(int treeId)
 
 	p2(("delete tree %d (%d)\n",treeId,trees_[treeId]));
 	ASSERT(trees_[treeId] >= 0);
+	unref(trees_[treeId]);
 	trees_.set(treeId,-1);
 	trees_.free(treeId, treesRB_);
 }
@@ -153,6 +166,7 @@ int Forest::newTree(int root)
 {
 #undef p2
 #define p2(a) //pr(a)
+	ref(root);
 	int treeId = trees_.alloc(root, treesRB_);
 	p2(("create tree %d (%d)\n",treeId,trees_[treeId]));
 	return treeId;
@@ -164,7 +178,14 @@ void Forest::insertChild(int parent, int child, int position, bool replaceExisti
 #undef p2
 #define p2(a) //pr(a)
 	p2(("insertChild parent=%d child=%d position=%d\n",parent,child,position));
-	graph_.newEdge(parent,child,position,replaceExisting);
+	ref(child);
+	if (replaceExisting) {
+		ASSERT(position >= 0);
+		int old = this->child(parent, position);
+		graph_.newEdge(parent,child,position,replaceExisting);
+		unref(old);
+	} else
+		graph_.newEdge(parent,child,position,replaceExisting);
 }
 
 void Forest::printTree(int treeId)
@@ -191,6 +212,8 @@ void Forest::printRootedTree(int root)
 
 void Forest::setRoot(int treeId, int root)
 {
+	ref(root);
+	unref(trees_[treeId]);
 	trees_.set(treeId,root);
 }
 
@@ -236,14 +259,60 @@ void Forest::garbageCollect()
 		paint(root, nodeFlags);
 	}
 
+	for (int i = 0; i < nodesUsed_.length(); i++) {
+		if (nodesUsed_.get(i)
+			&& !nodeFlags.get(i)) {
+				// remove the references from its edges; its children
+				// are either reachable, or will be deleted as well
+				Node &n = graph_.node(i);
+				for (int j = 0; j < n.nTotal(); j++)
+					refs_[n.edgeDest(j)]--;
+			}
+	}
 	for (int i = 0; i < nodesUsed_.length(); i++) {
 		if (nodesUsed_.get(i)
 			&& !nodeFlags.get(i)) {
 				p2((" recycling node %d\n",i));
-				nodesUsed_.set(i,false);
-				graph_.deleteNode(i);
+				deleteNode(i);
 			}
 	}
+	// the unreferenced nodes have all been deleted
+	unreferenced_.clear();
+}
+
+void Forest::deleteNode(int node)
+{
+	refs_[node] = 0;
+	nodesUsed_.set(node,false);
+	nodesInUse_--;
+	graph_.deleteNode(node);
+	if (cbFunc_ != 0)
+		cbFunc_(CMD_FREENODE, node, -1);
+}
+
+void Forest::freeNode(int node)
+{
+	Node &n = graph_.node(node);
+	for (int i = 0; i < n.nTotal(); i++)
+		unref(n.edgeDest(i));
+	deleteNode(node);
+}
+
+void Forest::reclaim()
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	// deleting a node may add its children to the list
+	while (!unreferenced_.isEmpty()) {
+		int node = unreferenced_.pop();
+		// skip nodes that have been referenced since they were
+		// recorded, or recorded more than once
+		if (!nodesUsed_.get(node) || refs_[node] > 0)
+			continue;
+		p2((" reclaiming node %d\n",node));
+		freeNode(node);
+	}
 }
 
 int Forest::rootNode(int treeId)
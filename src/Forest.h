@@ -29,9 +29,21 @@
 
 	4)	A tree can be deleted.  This doesn't delete the nodes, just 
 			deregisters the id associated with the tree.  A subsequent call
-			to garbageCollect() WILL delete the nodes, though... it performs
-			a search of the graph and retains only those nodes that are
-			reachable from the root of some non-deleted tree.
+			to reclaim() or garbageCollect() WILL delete the nodes, though.
+
+			Each node has a reference count: the number of trees rooted
+			at it, plus the number of edges leading to it.  Nodes whose
+			count drops to zero (and new nodes) are recorded, and reclaim()
+			deletes those that are still unreferenced, along with any
+			of their descendants that become unreferenced as a result.
+			Its cost is proportional to the number of nodes recorded,
+			not the size of the forest.  Since counts can drop to zero
+			temporarily while trees are being rewritten, reclaim() should
+			only be called when no rewriting is in progress.
+
+			garbageCollect() instead performs a search of the graph and
+			retains only those nodes that are reachable from the root of
+			some non-deleted tree.
 
 	5)	Once a tree or node id is assigned, it doesn't change until
 			the tree or node is deleted.  The id is an index >= 0 that can
@@ -128,6 +140,14 @@ public:
 	*/
 	void garbageCollect();
 
+	/*	Delete nodes that have become unreferenced since the last call
+	*/
+	void reclaim();
+
+	/*	Get number of nodes in use
+	*/
+	int nodes() const {return nodesInUse_;}
+
 	// callback function type
 	typedef int (cbForest)(int cmd, int arg1, int arg2);
 
@@ -136,8 +156,15 @@ public:
 		CMD_GETCODE,			// get node data associated with symbol 
 		CMD_INITNODE,			// initialize node data
 		CMD_PRINTTREE,		// print tree (debugging only; can be ignored)
+		CMD_FREENODE,			// node has been deleted; release its data
 	};
 
+	/*	Set callback to be informed when nodes are deleted (by
+			reclaim() or garbageCollect())
+			> cbFunc					callback function, or 0 for none
+	*/
+	void setCallback(cbForest *cbFunc) {cbFunc_ = cbFunc;}
+
 	/*	Match a pattern to a tree
 			> root						root of tree to apply pattern to
 			> pattern					script of pattern to apply
@@ -197,6 +224,29 @@ public:
 	void printRootedTree(int root);
 private:
 
+	/*	Add a reference to a node
+	*/
+	void ref(int node) {
+		refs_[node]++;
+	}
+
+	/*	Remove a reference to a node; if none remain, record it
+			for reclaim()
+	*/
+	void unref(int node) {
+		ASSERT(refs_[node] > 0);
+		if (--refs_[node] == 0)
+			unreferenced_.add(node);
+	}
+
+	/*	Delete a node, and remove the references from its edges
+	*/
+	void freeNode(int node);
+
+	/*	Delete a node, without regard to its edges
+	*/
+	void deleteNode(int node);
+
 	Graph graph_;
 
 	// list of trees (root nodes, or -1 if not active)
@@ -206,6 +256,14 @@ private:
 
 	// flags indicating whether node is used
 	BitStore nodesUsed_;
+	int nodesInUse_;
+
+	// reference count for each node
+	Array<int> refs_;
+	// nodes that may be unreferenced, to be examined by reclaim()
+	Array<int> unreferenced_;
+
+	cbForest *cbFunc_;
 };
 
 
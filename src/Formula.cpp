@@ -3,8 +3,6 @@
 #undef p2
 #define p2(a) //pr(a)
 
-Forest *Formula::forestPtr_;
-SArray<Token> *Formula::tokensPtr_;
 bool Formula::filterParen_;
 
 int Formula::root()
@@ -17,8 +15,7 @@ int Formula::root()
 }
 
 SArray<Token> &Formula::tokens() {
-	ASSERT(tokensPtr_ != 0);
-	return *tokensPtr_;
+	return Context::current().tokens();
 }
 
 //static int cnt;
@@ -92,8 +89,7 @@ int Formula::deepCopyAux(int src)
 }
 
 Forest &Formula::forest() {
-	ASSERT(forestPtr_ != 0);
-	return *forestPtr_;
+	return Context::current().forest();
 }
 
 void Formula::addFormula(Formula &f, int fStart, int ourParent, int childIndex,
@@ -166,6 +162,7 @@ void Formula::printToken(Token &t)
 	"EF ", // TK_EF,
 	"AX ", // TK_AX,
 	"EX ", // TK_EX,
+	0, // TK_DELTAOP,
 	(const char *)99	// TK_TOTAL
 	};
 
@@ -220,6 +217,7 @@ void Formula::printNode(int root, int priority) {
 	50, // TK_EF,
 	50, // TK_AX,
 	50, // TK_EX,
+	0, // TK_DELTAOP,
 	99	// TK_TOTAL
 	};
 	ASSERT(pri[TK_TOTAL] == 99);
@@ -457,6 +455,9 @@ int Formula::addToken(Token &t, int parent, int attachIndex) {
 		}
 		pt((" adding token to slot %d\n",tnum));
 		tokens().add(t, tnum);
+		// the token may refer to the scanner's text; only variables
+		// need their text once parsed
+		tokens()[tnum].detach(t.type(TK_PROPVAR));
 		return tnum;
 }
 
@@ -761,6 +762,14 @@ int Formula::cbFunc(int cmd, int arg1, int arg2)
 				}
 			}
 			break;
+		case Forest::CMD_FREENODE:
+			if (tokens().exists(arg1)) {
+				// release the token's text now, rather than when
+				// the slot is reused
+				tokens().set(arg1, Token());
+				tokens().free(arg1);
+			}
+			break;
 		default:
 			ASSERT(false);
 			break;
@@ -811,9 +820,6 @@ static const char *scriptsCTL[] = {
 		// AG		(symbol = E)
 		"mE",		"r0 u ! d u B u ! d u D d d u ! d",
 
-		// EG		(symbol = H)
-		"mH",		"r0 u ! d u I d u ! d",
-
 		// EF		(symbol = J)
 		"mJ",		"r0 u B u ! d u D d d",
 
@@ -1040,7 +1046,7 @@ int Formula::getLiteralCode(int root)
 	Token &t = Formula::token(root);
 	switch (t.type()) {
 		case TK_PROPVAR:
-			val = 2 + Vars::globalPtr()->var(t.str(), true);
+			val = 2 + Context::current().vars().var(t.text(), true);
 			break;
 		case TK_TRUE:
 			val = 1;
@@ -9,14 +9,6 @@
 class Formula {
 public:
 	
-	/*	Set global pointers to forest containing formulas, and
-			the array to hold their tokens
-	*/
-	static void setAuxDataStructures(Forest &forest, SArray<Token> &tokens) {
-		forestPtr_ = &forest;
-		tokensPtr_ = &tokens;
-	}
-
 	enum Constants {
 		// type of formula
 		TYPE_SIMPLE,
@@ -32,6 +24,25 @@ public:
 	Formula(const Formula &s);
 	// assignment operator
 	Formula& operator=(const Formula &s);
+#if HAS_MOVE
+	// move constructor
+	Formula(Formula &&s) {
+		construct();
+		swap(s);
+	}
+	// move assignment operator
+	Formula& operator=(Formula &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
+	/*	Exchange trees with another formula; unlike assignment, this
+			doesn't create or delete any trees
+	*/
+	void swap(Formula &s) {
+		swapVal(treeId_, s.treeId_);
+		swapVal(typeFlags_, s.typeFlags_);
+	}
 	/*	Make a deep copy of the formula by duplicating all the nodes
 	*/		
 	Formula deepCopy();
@@ -142,7 +153,8 @@ public:
 		filterParen_ = !f;
 	}
 
-	/*	Get forest containing formula
+	/*	Get forest containing formulas (that of this thread's
+			current Context)
 			< Forest
 	*/
 	static Forest &forest();
@@ -250,11 +262,6 @@ private:
 	// BF_xxx set for LTL, CTL specific connectives
 	int typeFlags_;
 
-	// ptr to forest containing nodes of formula
-	static Forest *forestPtr_;
-	// ptr to array of tokens
-	static SArray<Token> *tokensPtr_;
-
 	// if true, doesn't filter extraneous parentheses
 	static bool filterParen_;
 };
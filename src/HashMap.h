@@ -0,0 +1,206 @@
+#ifndef _HASHMAP
+#define _HASHMAP
+
+/*	Hashing and comparison of HashMap keys; specialized for each key
+		type.  Besides the key type itself, hash() and equal() may accept
+		other types that identify a key (such as a StrRef for a String
+		key), so a key can be looked up without constructing one.
+*/
+template <typename K>
+class HashKey;
+
+template <>
+class HashKey<int> {
+public:
+	static unsigned hash(int k) {return Utils::hashInt((unsigned)k);}
+	static bool equal(int a, int b) {return a == b;}
+};
+
+template <>
+class HashKey<String> {
+public:
+	static unsigned hash(const StrRef &k) {
+		return Utils::hashBytes(k.chars(), k.length());
+	}
+	static bool equal(const String &a, const StrRef &b) {
+		return b.equals(a);
+	}
+};
+
+/*	HashMap: hash table mapping keys to values, using open addressing
+		with linear probing.  Keys, values and their hash values are
+		stored together in a single array, so a lookup usually touches
+		only one or two cache lines, and keys are compared only if their
+		hash values match.
+*/
+template <typename K, typename V, typename H = HashKey<K> >
+class HashMap {
+public:
+	HashMap() {
+		used_ = 0;
+		mask_ = -1;
+	}
+
+	/*	Find the value associated with a key
+			> key							key, or something identifying one (see HashKey)
+			< pointer to value, or 0 if key not found
+	*/
+	template <typename Q>
+	V *find(const Q &key) const {
+		if (used_ == 0)
+			return 0;
+		Slot &s = slots_[locate(key, hashOf(key))];
+		return s.hash != 0 ? &s.value : 0;
+	}
+
+	/*	Associate a value with a key, replacing any existing value
+	*/
+	void set(const K &key, const V &value);
+
+	/*	Remove a key
+			< true if it was found
+	*/
+	template <typename Q>
+	bool remove(const Q &key);
+
+	void clear() {
+		Array<Slot> empty;
+		slots_.swap(empty);
+		used_ = 0;
+		mask_ = -1;
+	}
+
+	/*	Determine number of keys in map
+	*/
+	int length() const {return used_;}
+
+private:
+	// no copying allowed
+	HashMap(const HashMap &s);
+	HashMap& operator=(const HashMap &s);
+
+	class Slot {
+	public:
+		Slot() : hash(0), key(), value() {}
+		// hash value of key, or 0 if slot is empty
+		unsigned hash;
+		K key;
+		V value;
+	};
+
+	enum {
+		INITIAL_SIZE = 16
+	};
+
+	/*	Calculate hash value of a key; never zero, since that marks an
+			empty slot
+	*/
+	template <typename Q>
+	static unsigned hashOf(const Q &key) {
+		unsigned h = H::hash(key);
+		return h != 0 ? h : 1;
+	}
+
+	/*	Find the slot containing a key, or the empty slot where it
+			would be stored
+			> key							key
+			> h								hash value of key
+			< index of slot
+	*/
+	template <typename Q>
+	int locate(const Q &key, unsigned h) const {
+		int i = h & mask_;
+		while (true) {
+			const Slot &s = slots_[i];
+			if (s.hash == 0 || (s.hash == h && H::equal(s.key, key)))
+				return i;
+			i = (i + 1) & mask_;
+		}
+	}
+
+	/*	Move all keys to a new table
+			> capacity				number of slots; must be a power of 2
+	*/
+	void rehash(int capacity);
+
+	Array<Slot> slots_;
+	// number of keys stored
+	int used_;
+	// number of slots - 1
+	int mask_;
+};
+
+template <typename K, typename V, typename H>
+void HashMap<K,V,H>::set(const K &key, const V &value)
+{
+	// keep the table at most 3/4 full
+	if ((used_ + 1) * 4 > (mask_ + 1) * 3)
+		rehash(maxVal((int)INITIAL_SIZE, (mask_ + 1) * 2));
+
+	unsigned h = hashOf(key);
+	Slot &s = slots_[locate(key, h)];
+	if (s.hash == 0) {
+		s.hash = h;
+		s.key = key;
+		used_++;
+	}
+	s.value = value;
+}
+
+template <typename K, typename V, typename H>
+template <typename Q>
+bool HashMap<K,V,H>::remove(const Q &key)
+{
+	if (used_ == 0)
+		return false;
+	int i = locate(key, hashOf(key));
+	if (slots_[i].hash == 0)
+		return false;
+	used_--;
+
+	// move later keys of the probe sequence back into the hole, so no
+	// 'deleted' markers are needed
+	int j = i;
+	while (true) {
+		j = (j + 1) & mask_;
+		Slot &s = slots_[j];
+		if (s.hash == 0)
+			break;
+		int home = s.hash & mask_;
+		// leave the key alone if its home slot is cyclically in (i, j]
+		if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+			continue;
+		Slot &d = slots_[i];
+		d.hash = s.hash;
+		moveValue(d.key, s.key);
+		moveValue(d.value, s.value);
+		i = j;
+	}
+	Slot &d = slots_[i];
+	d.hash = 0;
+	d.key = K();
+	d.value = V();
+	return true;
+}
+
+template <typename K, typename V, typename H>
+void HashMap<K,V,H>::rehash(int capacity)
+{
+	Array<Slot> old;
+	old.swap(slots_);
+	slots_.ensureCapacity(capacity, false);
+	slots_.allocBuffer(capacity);
+	mask_ = capacity - 1;
+
+	for (int i = 0; i < old.length(); i++) {
+		Slot &s = old[i];
+		if (s.hash == 0)
+			continue;
+		Slot &d = slots_[locate(s.key, s.hash)];
+		d.hash = s.hash;
+		moveValue(d.key, s.key);
+		moveValue(d.value, s.value);
+	}
+}
+
+#endif // _HASHMAP
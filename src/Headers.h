@@ -47,6 +47,15 @@
 #include <cstdlib>
 using namespace std;
 
+// Move constructors and assignment operators are only defined if
+// the compiler supports them; otherwise, values are moved with swap()
+#if __cplusplus >= 201103L
+#define HAS_MOVE 1
+#include <utility>
+#else
+#define HAS_MOVE 0
+#endif
+
 // Forward reference to class String to be defined later:
 class String;
 typedef unsigned char byte;
@@ -70,8 +79,32 @@ void clamp(X &a, X b, X c) {
 		a = c;
 }
 
+template <typename X>
+inline void swapVal(X &a, X &b) {
+	X t = a;
+	a = b;
+	b = t;
+}
+
+/*	Move a value from one variable to another.  The source is left
+		in an unspecified (but valid) state.  Classes that own storage
+		provide overloads that exchange it with swap(), rather than
+		copying it.
+		> dest						destination
+		> src							source
+*/
+template <typename X>
+inline void moveValue(X &dest, X &src) {
+#if HAS_MOVE
+	dest = std::move(src);
+#else
+	dest = src;
+#endif
+}
+
 #include "Debug.h"
 #include "Array.h"
+#include "SmallArray.h"
 #include "MyString.h"
 #include "Utils.h"
 #include "Exception.h"
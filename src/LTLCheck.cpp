@@ -41,57 +41,121 @@ void LTLCheck::constructAutomaton(Formula &f, bool negate, Buchi &b)
 	if (!f.isLTL())
 		throw ParseException("Cannot construct automaton for non-LTL formulas");
 
+	Stats::Timer timer(Stats::PH_TABLEAU);
+
 	if (negate) {
-		f_ = f.negate();
+		Formula neg = f.negate();
+		f_.swap(neg);
 	}
 	else
 		f_ = f;
 	
-	nodes_.clear();
-
 	model_ = 0;
 	pvWarn_.clear();
-	nForest_.clear();
 	nodeList_.clear();
 	nodes_.clear();
+	arena_.clear();
 	initNode_ = -1;
 
 	// reduce formula to minimal set of connectives
-	f_.reduce();
+	{
+		MemAccount acc(MemAccount::FORMULA);
+		f_.reduce();
+	}
 	pt(("LTLCheck, checking formula\n    %s\n==> %s\n",
 		f.s(-1,true),f_.s(-1,true)));
 
-	createGraph();
+	{
+		MemAccount acc(MemAccount::TABLEAU);
+		createGraph();
+	}
+
+	MemAccount acc(MemAccount::BUCHI);
 
 	Buchi bg;
 	constructBuchi(bg);
 
+	// the tableau is no longer needed
+	nodeList_.clear();
+	nodes_.clear();
+	arena_.clear();
+
+	// merge similar states before degeneralizing, since that
+	// multiplies the number of states by the number of accept sets
+	Buchi bgs;
+	bg.simulationReduce(bgs);
+
 	Buchi bg2;
-	bg.convertGeneralized(bg2);
-	bg2.reduce(b);
+	bgs.convertGeneralized(bg2);
+	bg2.simulationReduce(b);
 //	bg.convertGeneralized(b);
 
+	Stats &st = Stats::current();
+	st.count(Stats::FORMULA_STATES, b.nStates());
+	st.count(Stats::FORMULA_TRANS, b.nTransitions());
 }
 
-void LTLCheck::check(Model &model, Formula &f)
+bool LTLCheck::check(Model &model, Formula &f)
 {
-#undef pt
-#define pt(a) //pr(a)
+	begin(f);
+	return finish(model);
+}
 
-	Buchi ngb;
-	constructAutomaton(f, true, ngb);
+void LTLCheck::begin(Formula &f)
+{
+	constructAutomaton(f, true, negAut_);
+	// the model's automaton needs only the variables known so far
+	nVars_ = vars_->length();
+	findStutterVars();
 	if (option(OPT_PRINTBUCHI)) {
 		Cout << "Formula automaton:\n";
-		ngb.print();
+		negAut_.print();
 		Cout << "\n";
 	}
+}
 
-	ASSERT(model.defined() );
-	model_ = &model;
+void LTLCheck::adopt(LTLCheck &c)
+{
+	negAut_.swap(c.negAut_);
+	nVars_ = c.nVars_;
+	stutter_ = c.stutter_;
+	stutterVars_ = c.stutterVars_;
+}
+
+void LTLCheck::findStutterVars()
+{
+	stutter_ = true;
+	stutterVars_.clear();
+
+	Array<int> nList;
+	f_.forest().getNodeList(f_.root(),nList);
+	for (int i = 0; i < nList.length(); i++) {
+		int root = nList[i];
+		int type = f_.nType(root);
+		if (type == TK_X)
+			stutter_ = false;
+		else if (type == TK_PROPVAR)
+			stutterVars_.add(Formula::getLiteralCode(root) - 2);
+	}
+}
+
+bool LTLCheck::search(const Model &m, Buchi &bProd, Array<int> &seq)
+{
+#undef pt
+#define pt(a) //pr(a)
+
+	Stats &st = Stats::current();
+	Buchi &ngb = negAut_;
 
 	// convert model to Buchi automaton
 	Buchi bModel;
-	bModel.convertKripke(model,*vars_);
+	{
+		Stats::Timer timer(Stats::PH_KRIPKE);
+		MemAccount acc(MemAccount::BUCHI);
+		bModel.convertKripke(m,nVars_);
+	}
+	st.count(Stats::MODEL_STATES, bModel.nStates());
+	st.count(Stats::MODEL_TRANS, bModel.nTransitions());
 	pt((" buchi for kripke model:\n%s",bModel.s() ));
 	if (option(OPT_PRINTBUCHI)) {
 		Cout << "Model automaton:\n";
@@ -99,14 +163,25 @@ void LTLCheck::check(Model &model, Formula &f)
 		Cout << "\n";
 	}
 
-	Buchi bProd;
 	Buchi bProd0;
-	bProd0.calcProduct(bModel,ngb);
+	{
+		Stats::Timer timer(Stats::PH_PRODUCT);
+		MemAccount acc(MemAccount::PRODUCT);
+		bProd0.calcProduct(bModel,ngb);
+	}
+	st.count(Stats::PRODUCT_STATES, bProd0.nStates());
+	st.count(Stats::PRODUCT_TRANS, bProd0.nTransitions());
 #if 1	// reduce product aut?
-	bProd0.reduce(bProd);
+	{
+		Stats::Timer timer(Stats::PH_REDUCE);
+		MemAccount acc(MemAccount::PRODUCT);
+		bProd0.reduce(bProd);
+	}
 #else
 	bProd = bProd0;
 #endif
+	st.count(Stats::REDUCED_STATES, bProd.nStates());
+	st.count(Stats::REDUCED_TRANS, bProd.nTransitions());
 
 	if (option(OPT_PRINTBUCHI)) {
 		Cout << "Product automaton:\n";
@@ -116,24 +191,82 @@ void LTLCheck::check(Model &model, Formula &f)
 
 	pt(("product:\n%s",prod.s() ));
 
+	bool found;
+	{
+		Stats::Timer timer(Stats::PH_EMPTINESS);
+		MemAccount acc(MemAccount::DFS);
+		found = bProd.nonEmpty(seq);
+	}
+	st.count(Stats::DFS_STATES, bProd.dfsVisits());
+	return found;
+}
+
+bool LTLCheck::finish(Model &model)
+{
+	ASSERT(model.defined() );
+	model_ = &model;
+
+	// A formula without X has the same value in the model's stuttering
+	// quotient, which may be much smaller.  A counterexample found
+	// there isn't necessarily a path of the model, though, so it's
+	// converted to one that passes through the same classes.
+	Model quotient(*vars_);
+	Array<int> classOf;
+	bool useQuotient = false;
+	if (stutter_ && !option(OPT_PRINTBUCHI)) {
+		Stats::Timer timer(Stats::PH_KRIPKE);
+		MemAccount acc(MemAccount::BUCHI);
+		useQuotient = model.stutterQuotient(stutterVars_, quotient, &classOf);
+	}
+
+	Buchi bProd;
 	Array<int> seq;
-	if (bProd.nonEmpty(seq)) {
+	bool found = search(useQuotient ? quotient : model, bProd, seq);
+
+	// the formula's automaton is no longer needed
+	{
+		Buchi empty;
+		negAut_.swap(empty);
+	}
+
+	cex_.clear();
+	cexLoop_ = -1;
+
+	if (found) {
 		//Utils::printIntArray(seq,"Sequence");
 		Cout << "Not satisfied; counterexample:\n";
 		int rep = repeatPoint(seq);
-		
+
+		// the product's states are labelled with the names of the
+		// model's states; the first state of the sequence is the
+		// automaton's initial state, which has no counterpart
+		for (int i = 1; i < seq.length(); i++)
+			cex_.add(bProd.stateName(seq[i]));
+		if (rep > 0)
+			cexLoop_ = rep - 1;
+
+		if (useQuotient) {
+			Stats::Timer timer(Stats::PH_EMPTINESS);
+			MemAccount acc(MemAccount::DFS);
+			Array<int> path;
+			cexLoop_ = model.stutterPath(classOf, cex_, cexLoop_, path);
+			cex_.swap(path);
+		}
+
+		// the sequence is truncated unless it's to be printed in full,
+		// so stop once there's enough of it
+		int maxLen = option(OPT_PRINTFULLSEQ) ? -1 : 75;
 		String w;
 		w << "  ";
-		for (int i = 1; i < seq.length(); i++) {
-			int s = seq[i];
-//			int s = seq[i] % bModel.nStates();
-			if (i > 1) w << ' ';
-			if (i == rep)
+		for (int i = 0; i < cex_.length(); i++) {
+			if (maxLen >= 0 && w.length() > maxLen)
+				break;
+			if (i > 0) w << ' ';
+			if (i == cexLoop_)
 				w << "{";
-			//Cout << s << ":";
-			w << bProd.stateLabel(s);
+			w << cex_[i];
 		}
-		if (rep >= 0)
+		if (cexLoop_ >= 0)
 			w << "}*";
 		if (!option(OPT_PRINTFULLSEQ))
 			w.truncate(75,true);
@@ -141,6 +274,7 @@ void LTLCheck::check(Model &model, Formula &f)
 	} else
 		Cout << "Satisfied.\n";
 	Cout << "\n";
+	return !found;
 }
 
 #if DEBUG
@@ -152,7 +286,7 @@ const char *LTLCheck::Node::s()
 	Cout << "  in:" << incoming.debInfo().chars() << "\n";
 	for (int i = 0; i < 3; i++) {
 		static const char *names[] = {" old"," new","next"};
-		OrdSet &lst = (i == 0 ? fOld : (i == 1 ? fNew : fNext));
+		ArenaSet &lst = (i == 0 ? fOld : (i == 1 ? fNew : fNext));
 		Cout << names[i] << ":\n";
 		for (int j = 0; j < lst.length(); j++) {
 			int root = lst.itemAt(j);
@@ -169,9 +303,8 @@ const char *LTLCheck::Node::s()
 
 int LTLCheck::newNode()
 {
-	int node = nForest_.newNode();
-	Node n;
-	nodes_.add(n,node);
+	int node = nodes_.alloc(new (arena_.alloc(sizeof(Node))) Node(arena_));
+	Stats::current().count(Stats::TABLEAU_NODES);
 	return node;
 }
 
@@ -356,12 +489,14 @@ void LTLCheck::expand(int q)
 					}
 
 					{
+						// q isn't needed after this, so its sets can be
+						// moved to the last node replacing it
 						int id2;
 						Node &n2 = newNode(id2);
 
-						n2.incoming = qr.incoming;
+						n2.incoming.swap(qr.incoming);
 
-						n2.fNew = qr.fNew;
+						n2.fNew.swap(qr.fNew);
 						switch (etype) {
 						case TK_U:
 						case TK_OR:
@@ -373,10 +508,10 @@ void LTLCheck::expand(int q)
 							break;
 						}
 
-						n2.fOld = qr.fOld;
+						n2.fOld.swap(qr.fOld);
 						n2.fOld.add(e);
 
-						n2.fNext = qr.fNext;
+						n2.fNext.swap(qr.fNext);
 						expand(id2);
 					}
 				}
@@ -387,16 +522,16 @@ void LTLCheck::expand(int q)
 						int id1;
 						Node &n1 = newNode(id1);
 
-						n1.incoming = qr.incoming;
+						n1.incoming.swap(qr.incoming);
 
-						n1.fNew = qr.fNew;
+						n1.fNew.swap(qr.fNew);
 						n1.fNew.add(f_.child(e,0));
 						n1.fNew.add(f_.child(e,1));
 
-						n1.fOld = qr.fOld;
+						n1.fOld.swap(qr.fOld);
 						n1.fOld.add(e);
 
-						n1.fNext = qr.fNext;
+						n1.fNext.swap(qr.fNext);
 						expand(id1);
 					}
 				break;
@@ -406,14 +541,14 @@ void LTLCheck::expand(int q)
 						int id1;
 						Node &n1 = newNode(id1);
 
-						n1.incoming = qr.incoming;
+						n1.incoming.swap(qr.incoming);
 
-						n1.fNew = qr.fNew;
+						n1.fNew.swap(qr.fNew);
 
-						n1.fOld = qr.fOld;
+						n1.fOld.swap(qr.fOld);
 						n1.fOld.add(e);
 
-						n1.fNext = qr.fNext;
+						n1.fNext.swap(qr.fNext);
 						n1.fNext.add(f_.child(e,0));
 
 						expand(id1);
@@ -461,8 +596,9 @@ void LTLCheck::constructBuchi(Buchi &b)
 	b.clear();
 
 	// construct a translation table for existing state numbers to
-	// buchi state numbers
-	Array<int> newNums;
+	// buchi state numbers (indexed by state number, which can be more
+	// than an Array allows)
+	SArray<int> newNums;
 	for (int i = 0; i <= nodeList_.lastItem(); i++) {
 		int n = nodeList_[i];
 		pt((" old state = %d, new is %d\n",n,i));
@@ -525,7 +661,7 @@ void LTLCheck::constructBuchi(Buchi &b)
 					set.set(newNums[si]);
 				}
 			}
-			b.addAcceptSet(set);
+			b.addAcceptSetMove(set);
 		}
 	}
 
@@ -533,7 +669,85 @@ void LTLCheck::constructBuchi(Buchi &b)
 }
 
 
-void LTLCheck::compare(Formula &f1, Formula &f2, bool printReduced)
+/*	Checks one direction of a comparison: whether the product of
+		one formula's automaton with the automaton of the other's
+		negation is nonempty.  May be run in its own thread.
+*/
+class LTLCheck::CompareTask : public Thread {
+public:
+	CompareTask() {
+		found = false;
+		cancel = 0;
+		check = MemAccount::check();
+	}
+	virtual void run();
+
+	// automaton for first formula, and negation of second
+	Buchi b1, b2;
+	// (reduced) product automaton
+	Buchi prod;
+	// accepting sequence, if product is nonempty
+	Array<int> seq;
+	// true if sequence was found
+	bool found;
+	// if not 0, flag that is set when a sequence is found,
+	// and polled to abandon the search
+	volatile bool *cancel;
+	// statistics for this direction
+	Stats stats;
+	// memory check of the comparison, which this direction's
+	// allocations are charged to
+	MemAccount::Check *check;
+};
+
+void LTLCheck::CompareTask::run()
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	p2(("first automaton:\n%s",b1.s() ));
+	p2(("second automaton:\n%s",b2.s() ));
+
+	MemAccount::Check::Use useCheck(check);
+
+#if 1
+	Buchi prod0;
+	{
+		Stats::Timer timer(Stats::PH_PRODUCT, stats);
+		MemAccount acc(MemAccount::PRODUCT);
+		prod0.calcProduct(b1,b2);
+	}
+	stats.count(Stats::PRODUCT_STATES, prod0.nStates());
+	stats.count(Stats::PRODUCT_TRANS, prod0.nTransitions());
+	if ((cancel != 0 && *cancel) || MemAccount::exceeded())
+		return;
+	{
+		Stats::Timer timer(Stats::PH_REDUCE, stats);
+		MemAccount acc(MemAccount::PRODUCT);
+		prod0.reduce(prod);
+	}
+#else
+	prod.calcProduct(b1,b2);
+#endif
+	stats.count(Stats::REDUCED_STATES, prod.nStates());
+	stats.count(Stats::REDUCED_TRANS, prod.nTransitions());
+	p2(("product:\n%s",prod.s() ));
+	if ((cancel != 0 && *cancel) || MemAccount::exceeded())
+		return;
+
+	prod.setCancelFlag(cancel);
+	{
+		Stats::Timer timer(Stats::PH_EMPTINESS, stats);
+		MemAccount acc(MemAccount::DFS);
+		found = prod.nonEmpty(seq);
+	}
+	stats.count(Stats::DFS_STATES, prod.dfsVisits());
+	prod.setCancelFlag(0);
+	if (found && cancel != 0)
+		*cancel = true;
+}
+
+bool LTLCheck::compare(Formula &f1, Formula &f2, bool printReduced)
 {
 #undef p2
 #define p2(a) //pr(a)
@@ -555,114 +769,183 @@ void LTLCheck::compare(Formula &f1, Formula &f2, bool printReduced)
 	}
 	Cout << "\n";
 
-	Buchi b1, b2;
+	// The automata are always constructed on this thread, since that
+	// manipulates the formula forest.  The products and emptiness
+	// checks can run concurrently, unless they are to be printed.
+	bool concurrent = option(OPT_CONCURRENT)
+		&& !option(OPT_PRINTSTATES | OPT_PRINTBUCHI);
 
-	bool equiv = true;
+	CompareTask task[2];
+	volatile bool cancel = false;
 
 	for (int pass = 0; pass < 2; pass++) {
+		diff_[pass].clear();
+		diffLoop_[pass] = -1;
+	}
 
-		if (pass == 0) {
-			if (option(OPT_PRINTSTATES))
-				Cout << "First automaton:\n";
-			constructAutomaton(f1, false, b1);
-			if (option(OPT_PRINTSTATES))
-				Cout << "Second automaton:\n";
-			constructAutomaton(f2, true, b2);
-		} else {
-			if (option(OPT_PRINTSTATES))
+	bool equiv = true;
+
+	// if constructing the second pair of automata fails, the first
+	// pass's thread must be waited for before the tasks are destroyed
+	try {
+		for (int pass = 0; pass < 2; pass++) {
+			CompareTask &t = task[pass];
+			Buchi &b1 = t.b1;
+			Buchi &b2 = t.b2;
+
+			if (pass == 0) {
+				if (option(OPT_PRINTSTATES))
+					Cout << "First automaton:\n";
+				constructAutomaton(f1, false, b1);
+				if (option(OPT_PRINTSTATES))
+					Cout << "Second automaton:\n";
+				constructAutomaton(f2, true, b2);
+			} else {
+				if (option(OPT_PRINTSTATES))
+					Cout << "First automaton:\n";
+				constructAutomaton(f2, false, b1);
+				if (option(OPT_PRINTSTATES))
+					Cout << "Second automaton:\n";
+				constructAutomaton(f1, true, b2);
+			}
+
+			// label first automaton with description of its prop.var values
+			b1.setPropVarLabels(*vars_);
+
+			if (option(OPT_PRINTBUCHI)) {
 				Cout << "First automaton:\n";
-			constructAutomaton(f2, false, b1);
-			if (option(OPT_PRINTSTATES))
+				b1.print();
+				Cout << "\n";
 				Cout << "Second automaton:\n";
-			constructAutomaton(f1, true, b2);
-		}
+				b2.print();
+				Cout << "\n";
+			}
+
+			// if only the verdict is required, either direction can stop
+			// as soon as the other finds a sequence
+			if (option(OPT_BRIEF))
+				t.cancel = &cancel;
 
-		// label first automaton with description of its prop.var values
-		b1.setPropVarLabels(*vars_);
+			if (concurrent) {
+				t.start(THREAD_STACK_SIZE);
+				continue;
+			}
 
-		if (option(OPT_PRINTBUCHI)) {
-			Cout << "First automaton:\n";
-			b1.print();
-			Cout << "\n";
-			Cout << "Second automaton:\n";
-			b2.print();
-			Cout << "\n";
+			t.run();
+			reportPass(t, pass, equiv);
+			if (!equiv && option(OPT_BRIEF))
+				break;
+		}
+	} catch (Exception &e) {
+		if (concurrent) {
+			cancel = true;
+			for (int pass = 0; pass < 2; pass++) {
+				try {
+					task[pass].join();
+				} catch (Exception &e2) {
+				}
+			}
 		}
+		throw;
+	}
 
-		p2(("first automaton:\n%s",b1.s() ));
-		p2(("second automaton:\n%s",b2.s() ));
+	if (concurrent) {
+		// wait for both threads before reporting any problems
+		Exception err;
+		bool failed = false;
+		for (int pass = 0; pass < 2; pass++) {
+			try {
+				task[pass].join();
+			} catch (Exception &e) {
+				err = e;
+				failed = true;
+			}
+		}
+		if (failed)
+			throw err;
 
+		for (int pass = 0; pass < 2; pass++)
+			reportPass(task[pass], pass, equiv);
+	}
 
-		Buchi prod;
-#if 1
-		Buchi prod0;
-		prod0.calcProduct(b1,b2);
-		prod0.reduce(prod);
-#else
-		prod.calcProduct(b1,b2);
-#endif
-		p2(("product:\n%s",prod.s() ));
-		if (option(OPT_PRINTBUCHI|OPT_PRINTSTATES)) {
-			Cout << "Product automaton:\n";
-			prod.print();
-			Cout << "\n";
-		}
+	if (equiv)
+		Cout << "Equivalent.\n";
+	Cout << "\n";
+	return equiv;
+}
 
-		Array<int> seq;
+void LTLCheck::reportPass(CompareTask &t, int pass, bool &equiv)
+{
+	Buchi &prod = t.prod;
+	Array<int> &seq = t.seq;
 
-		if (prod.nonEmpty(seq)) {
-			//pr(("seq length=%d\n",seq.length()));
+	Stats::current().add(t.stats);
 
-			if (equiv) {
-				equiv = false;
-				Cout << "Not equivalent.\n";
-			}
+	if (option(OPT_PRINTBUCHI|OPT_PRINTSTATES)) {
+		Cout << "Product automaton:\n";
+		prod.print();
+		Cout << "\n";
+	}
 
-			String buff;
-			Utils::pushSink(&buff);
-			{
-				Cout << "\n";
-				Cout << (pass == 0 ? " first" : "second") << " allows: ";
+	if (!t.found)
+		return;
+
+	//pr(("seq length=%d\n",seq.length()));
+
+	if (equiv) {
+		equiv = false;
+		Cout << "Not equivalent.\n";
+	}
+
+	// the first state of the sequence is the product's initial state,
+	// which isn't described
+	int rep = repeatPoint(seq);
+	for (int i = 1; i < seq.length(); i++)
+		diff_[pass].add(prod.stateLabel(seq[i]));
+	if (rep > 0)
+		diffLoop_[pass] = rep - 1;
+
+	if (option(OPT_BRIEF))
+		return;
+
+	String buff;
+	Utils::pushSink(&buff);
+	{
+		Cout << "\n";
+		Cout << (pass == 0 ? " first" : "second") << " allows: ";
 
-				// find repeat point
+		// find repeat point
 #if 0
-				int rep = repeatPoint(seq);
-				BitStore bs;
-				int rep = -1;
-				for (int i = seq.length()-1; i > 0; i--) {
-					int s = seq[i];
-					if (bs[s]) {
-						rep = i;
-						break;
-					}
-					bs.set(s);
-				}
+		int rep = repeatPoint(seq);
+		BitStore bs;
+		int rep = -1;
+		for (int i = seq.length()-1; i > 0; i--) {
+			int s = seq[i];
+			if (bs[s]) {
+				rep = i;
+				break;
+			}
+			bs.set(s);
+		}
 #endif
-				int rep = repeatPoint(seq);
 
-				for (int i = 1; i < seq.length(); i++) {
-					int s = seq[i];
-					const String &str = prod.stateLabel(s);
+		for (int i = 1; i < seq.length(); i++) {
+			int s = seq[i];
+			String str = prod.stateLabel(s);
 
-					if (i > 1) Cout << ' ';
+			if (i > 1) Cout << ' ';
 
-					if (i == rep) {
-						Cout << "{";
-					}
-					Cout << str;
-				}
-				Cout << "}*\n";
+			if (i == rep) {
+				Cout << "{";
 			}
-			Utils::popSink();
-			if (!option(OPT_PRINTFULLSEQ)) {
-				buff.truncate(75,true);
-				buff << '\n';
-			}
-			Cout << buff;
+			Cout << str;
 		}
+		Cout << "}*\n";
 	}
-	if (equiv)
-		Cout << "Equivalent.\n";
-	Cout << "\n";
+	Utils::popSink();
+	if (!option(OPT_PRINTFULLSEQ)) {
+		buff.truncate(75,true);
+		buff << '\n';
+	}
+	Cout << buff;
 }
-
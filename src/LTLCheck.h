@@ -9,19 +9,69 @@ public:
 	LTLCheck(Vars &vars, int options = 0) {
 		vars_ = &vars;
 		options_ = options;
+		cexLoop_ = -1;
+		diffLoop_[0] = diffLoop_[1] = -1;
+		stutter_ = false;
 	}
 
 	/*	Check a formula
 			> model						model to check
 			> f								specification (LTL formula)
+			< true if model satisfies formula
 	*/
-	void check(Model &model, Formula &f);
+	bool check(Model &model, Formula &f);
+
+	/*	Begin checking a formula, by constructing the automaton for
+			its negation.  This modifies the formula forest and the symbol
+			table, so it must be done by the thread that owns them;
+			finish() only reads them, so different checks can be finished
+			concurrently, each by its own LTLCheck object.
+			> f								specification (LTL formula)
+	*/
+	void begin(Formula &f);
+
+	/*	Take over a check started by another object's begin(), so
+			this one can finish it while the other begins another
+	*/
+	void adopt(LTLCheck &c);
+
+	/*	Finish a check started by begin()
+			> model						model to check
+			< true if model satisfies formula
+	*/
+	bool finish(Model &model);
 
 	/*	Compare two LTL formulas
 			> f1
 			> f2
+			< true if equivalent
 	*/
-	void compare(Formula &f1, Formula &f2, bool printReduced = false);
+	bool compare(Formula &f1, Formula &f2, bool printReduced = false);
+
+	/*	Get the counterexample found by the last check
+			> loop						where to store the index of the state
+												the counterexample repeats from, or -1
+			< names of the model's states along the counterexample;
+				empty if the model satisfied the formula
+	*/
+	const Array<int> &counterexample(int &loop) const {
+		loop = cexLoop_;
+		return cex_;
+	}
+
+	/*	Get a sequence found by the last comparison that is allowed
+			by one formula, but not the other
+			> pass						0 for a sequence allowed by the first
+												formula, 1 for one allowed by the second
+			> loop						where to store the index of the step
+												the sequence repeats from, or -1
+			< description of the prop. var values in each step; empty
+				if no such sequence was found
+	*/
+	const StringArray &difference(int pass, int &loop) const {
+		loop = diffLoop_[pass];
+		return diff_[pass];
+	}
 
 #if DEBUG
 	const char *s() const;
@@ -31,6 +81,11 @@ public:
 		OPT_PRINTSTATES = 0x0001,
 		OPT_PRINTFULLSEQ = 0x0002,
 		OPT_PRINTBUCHI = 0x0004,
+		// compare: check both directions concurrently
+		OPT_CONCURRENT = 0x0008,
+		// compare: print only whether formulas are equivalent, and
+		// stop as soon as either direction finds a difference
+		OPT_BRIEF = 0x0010,
 	};
 
 private:
@@ -38,6 +93,22 @@ private:
 		return (options_ & flag) != 0;
 	}
 
+	/*	Search the product of a model's automaton and that of the
+			formula's negation for an accepting sequence
+			> m								model
+			> bProd						where to store (reduced) product
+			> seq							where to store sequence, if found
+			< true if sequence was found
+	*/
+	bool search(const Model &m, Buchi &bProd, Array<int> &seq);
+
+	/*	Determine if the formula being checked (as reduced) is free of
+			X, and if so, the variables it refers to; it can then be
+			checked against the model's stuttering quotient with respect
+			to them
+	*/
+	void findStutterVars();
+
 	/*	Construct a Buchi automaton for a formula
 			> f								specification (LTL formula)
 			> negate					true if formula should be negated
@@ -45,6 +116,23 @@ private:
 	*/
 	void constructAutomaton(Formula &f, bool negate, Buchi &b);
 
+	// one direction of a comparison (defined in LTLCheck.cpp)
+	class CompareTask;
+
+	enum {
+		// stack size for comparison threads; emptiness checking is
+		// recursive, so it's larger than usual
+		THREAD_STACK_SIZE = 1 << 26
+	};
+
+	/*	Print the results of one direction of a comparison
+			> t								task, after it has been run
+			> pass						0 or 1
+			> equiv						true if formulas are equivalent so far;
+												cleared if this direction found a difference
+	*/
+	void reportPass(CompareTask &t, int pass, bool &equiv);
+
 
 	/*	Create automaton states
 	*/
@@ -55,17 +143,20 @@ private:
 	*/
 	void expand(int node);
 
-	/*	Node class for constructing automaton
+	/*	Node class for constructing automaton.  Nodes and their sets
+			are allocated from the arena.
 	*/
 	class Node {
 	public:
+		Node(Arena &arena)
+		: incoming(arena), fOld(arena), fNew(arena), fNext(arena) {}
 		// list of predecessor nodes
-		OrdSet incoming;
+		ArenaSet incoming;
 		// subformulas already processed
-		OrdSet fOld;
-		OrdSet fNew;
+		ArenaSet fOld;
+		ArenaSet fNew;
 		// subformulas yet to be processed
-		OrdSet fNext;
+		ArenaSet fNext;
 #if DEBUG
 		const char *s();
 #endif
@@ -75,14 +166,13 @@ private:
 
 //	void processFormula(int root);
 
-	/*	Construct a new state in the forest, and allocate
-			its Node in the forest auxilliary data store
+	/*	Construct a new state, and allocate its Node
 
 			< id of node
 	*/
 	int newNode();
 
-	/*	Construct a new state in the forest, return reference to it
+	/*	Construct a new state, return reference to it
 			< id							id of node stored here
 			< reference to node
 	*/
@@ -100,7 +190,7 @@ private:
 			< reference to Node
 	*/
 	Node &node(int n) {
-		return nodes_[n];
+		return *nodes_[n];
 	}
 
 	void printStateSet(bool skipNew = false);
@@ -109,24 +199,44 @@ private:
 	// specification being checked, in reduced form
 	Formula f_;
 
+	// automaton for negation of formula being checked
+	Buchi negAut_;
+	// number of variables in symbol table when it was constructed
+	int nVars_;
+	// true if formula contains no X, and the variables it refers to
+	bool stutter_;
+	OrdSet stutterVars_;
+
 	// model being checked
 	Model *model_;
 
+	// counterexample found by last check, as state names, and the
+	// index it repeats from
+	Array<int> cex_;
+	int cexLoop_;
+
+	// sequences found by last comparison, in each direction
+	StringArray diff_[2];
+	int diffLoop_[2];
+
 	// flags indicating which vars we've printed warnings about
 	BitStore pvWarn_;
 
 	// symbol table
 	Vars *vars_;
 
-	// automaton states
-	Forest nForest_;
-
 	// LTL -> automaton conversion:
 
 	typedef SArray<int> NodeList;
 	NodeList nodeList_;
 
-	SArray<Node> nodes_;
+	// automaton states, indexed by id; there can be more than an
+	// Array allows, so they're stored in pages
+	SArray<Node *> nodes_;
+
+	// storage for the states, and their sets; released when each
+	// automaton has been constructed
+	Arena arena_;
 
 	// id of special 'init' node
 	int initNode_;
@@ -0,0 +1,63 @@
+#include "Headers.h"
+#include "Literals.h"
+
+void Literals::growOverflow(int words)
+{
+	while (ovTrue_.length() < words) {
+		ovTrue_.add(0);
+		ovFalse_.add(0);
+	}
+}
+
+void Literals::addOverflow(int var, bool value)
+{
+	int i = var / BITS - WORDS;
+	growOverflow(i + 1);
+	Word bit = ((Word)1) << (var % BITS);
+	if (value)
+		ovTrue_[i] |= bit;
+	else
+		ovFalse_[i] |= bit;
+}
+
+bool Literals::compatibleOverflow(const Literals &other) const
+{
+	int n = maxVal(ovTrue_.length(), other.ovTrue_.length());
+	for (int i = 0; i < n; i++) {
+		Word t = 0, f = 0;
+		if (i < ovTrue_.length()) {
+			t |= ovTrue_[i];
+			f |= ovFalse_[i];
+		}
+		if (i < other.ovTrue_.length()) {
+			t |= other.ovTrue_[i];
+			f |= other.ovFalse_[i];
+		}
+		if ((t & f) != 0)
+			return false;
+	}
+	return true;
+}
+
+void Literals::includeOverflow(const Literals &other)
+{
+	growOverflow(other.ovTrue_.length());
+	for (int i = 0; i < other.ovTrue_.length(); i++) {
+		ovTrue_[i] |= other.ovTrue_[i];
+		ovFalse_[i] |= other.ovFalse_[i];
+	}
+}
+
+bool Literals::containsOverflow(const Literals &other) const
+{
+	for (int i = 0; i < other.ovTrue_.length(); i++) {
+		Word t = 0, f = 0;
+		if (i < ovTrue_.length()) {
+			t = ovTrue_[i];
+			f = ovFalse_[i];
+		}
+		if ((other.ovTrue_[i] & ~t) | (other.ovFalse_[i] & ~f))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,139 @@
+#ifndef _LITERALS
+#define _LITERALS
+
+/*	Set of literals (prop. vars that must be true, or must be false),
+		stored as packed bit masks.  The first WORDS * BITS variables
+		are stored inline, so testing or combining two sets is a few
+		word operations and requires no allocation; any variables
+		beyond that are stored in overflow arrays, which are
+		only allocated if needed.
+*/
+class Literals {
+public:
+	Literals() {
+		for (int i = 0; i < WORDS; i++) {
+			true_[i] = 0;
+			false_[i] = 0;
+		}
+	}
+
+	/*	Exchange contents with another set, without copying
+	*/
+	void swap(Literals &s) {
+		for (int i = 0; i < WORDS; i++) {
+			swapVal(true_[i], s.true_[i]);
+			swapVal(false_[i], s.false_[i]);
+		}
+		ovTrue_.swap(s.ovTrue_);
+		ovFalse_.swap(s.ovFalse_);
+	}
+
+	/*	Specify a prop. var. that must be defined
+			> var							index of variable
+			> value						true or false, the value it must have
+	*/
+	void add(int var, bool value) {
+		if (var < WORDS * BITS) {
+			Word bit = ((Word)1) << (var % BITS);
+			if (value)
+				true_[var / BITS] |= bit;
+			else
+				false_[var / BITS] |= bit;
+		} else
+			addOverflow(var, value);
+	}
+
+	/*	Determine if a variable must be true
+	*/
+	bool mustBeTrue(int var) const {
+		return test(true_, ovTrue_, var);
+	}
+
+	/*	Determine if a variable must be false
+	*/
+	bool mustBeFalse(int var) const {
+		return test(false_, ovFalse_, var);
+	}
+
+	/*	Determine an upper bound on the variables in the set
+			< one more than the highest variable that may be defined
+	*/
+	int length() const {
+		return (WORDS + ovTrue_.length()) * BITS;
+	}
+
+	/*	Determine if the literals of this set and another can be
+			satisfied by a single assignment
+			< true if no variable must be both true and false
+	*/
+	bool compatible(const Literals &other) const {
+		Word w = 0;
+		for (int i = 0; i < WORDS; i++)
+			w |= (true_[i] | other.true_[i]) & (false_[i] | other.false_[i]);
+		if (w == 0 && !(ovTrue_.isEmpty() && other.ovTrue_.isEmpty()))
+			return compatibleOverflow(other);
+		return w == 0;
+	}
+
+	/*	Determine if some variable must be both true and false
+	*/
+	bool contradiction() const {
+		return !compatible(*this);
+	}
+
+	/*	Add the literals of another set to this one
+			> other						set to include
+	*/
+	void include(const Literals &other) {
+		for (int i = 0; i < WORDS; i++) {
+			true_[i] |= other.true_[i];
+			false_[i] |= other.false_[i];
+		}
+		if (!other.ovTrue_.isEmpty())
+			includeOverflow(other);
+	}
+
+	/*	Determine if every literal of another set is in this one
+			(i.e., if this set implies the other)
+			> other						set to test
+	*/
+	bool contains(const Literals &other) const {
+		Word w = 0;
+		for (int i = 0; i < WORDS; i++)
+			w |= (other.true_[i] & ~true_[i]) | (other.false_[i] & ~false_[i]);
+		if (w == 0 && !other.ovTrue_.isEmpty())
+			return containsOverflow(other);
+		return w == 0;
+	}
+
+private:
+	typedef unsigned long long Word;
+	enum {
+		BITS = 64,
+		// number of inline words for each of the true, false masks
+		WORDS = 2
+	};
+
+	static bool test(const Word *w, const Array<Word> &ov, int var) {
+		if (var < WORDS * BITS)
+			return (w[var / BITS] >> (var % BITS)) & 1;
+		int i = var / BITS - WORDS;
+		return i < ov.length() && ((ov[i] >> (var % BITS)) & 1);
+	}
+
+	void growOverflow(int words);
+	void addOverflow(int var, bool value);
+	bool compatibleOverflow(const Literals &other) const;
+	void includeOverflow(const Literals &other);
+	bool containsOverflow(const Literals &other) const;
+
+	Word true_[WORDS];
+	Word false_[WORDS];
+
+	// words for variables past the inline ones; these always have
+	// the same length
+	Array<Word> ovTrue_;
+	Array<Word> ovFalse_;
+};
+
+#endif // _LITERALS
@@ -0,0 +1,172 @@
+#include "globals.h"
+
+THREAD_LOCAL int MemAccount::current_;
+THREAD_LOCAL MemAccount::Check *MemAccount::check_;
+
+// bytes in use by each account, and their high-water marks
+static volatile long long inUse_[MemAccount::TOTAL];
+static volatile long long peak_[MemAccount::TOTAL];
+static volatile long long total_;
+static volatile long long peakTotal_;
+
+// budget for each check, or 0 if none
+static long long budget_;
+
+static const char *accountNames[] = {
+	"other",
+	"model",
+	"formula",
+	"tableau",
+	"buchi",
+	"product",
+	"dfs",
+	"ctl",
+};
+
+/*	Add to a counter, which may be shared by several threads
+		< new value of counter
+*/
+static long long atomicAdd(volatile long long &v, long long n)
+{
+#if UNIX
+	return __sync_add_and_fetch(&v, n);
+#else
+	return v += n;
+#endif
+}
+
+/*	Raise a high-water mark, which may be shared by several threads
+		> mark							mark to raise
+		> value							value it must be at least
+*/
+static void raiseMark(volatile long long &mark, long long value)
+{
+#if UNIX
+	// read the mark atomically, as other threads may be raising it
+	long long m = __sync_fetch_and_add(&mark, 0);
+	while (m < value) {
+		long long prev = __sync_val_compare_and_swap(&mark, m, value);
+		if (prev == m)
+			break;
+		m = prev;
+	}
+#else
+	if (mark < value)
+		mark = value;
+#endif
+}
+
+void MemAccount::charge(int account, long long bytes)
+{
+	ASSERT(account >= 0 && account < TOTAL);
+
+	Check *c = check_;
+	if (c != 0) {
+		// test the budget before allocating anything, so the caller is
+		// left unchanged by the exception.  Only the first allocation
+		// to exceed it throws; the exception itself, and the code that
+		// handles it, must be able to allocate.
+		long long total = atomicAdd(c->total_, bytes);
+		if (budget_ > 0 && total > budget_ && !c->exceeded_) {
+#if UNIX
+			bool first = __sync_bool_compare_and_swap(&c->exceeded_, false, true);
+#else
+			bool first = !c->exceeded_;
+			c->exceeded_ = true;
+#endif
+			if (first) {
+				atomicAdd(c->total_, -bytes);
+				String msg;
+				char work[40];
+				sprintf(work, "%lld", bytes);
+				msg << "Memory budget of " << (int)(budget_ >> 10)
+					<< " KB exceeded while allocating " << work
+					<< " bytes for " << name(account) << "; in use (KB):";
+				for (int i = 0; i < TOTAL; i++) {
+					if (c->inUse_[i] <= 0) continue;
+					msg << " " << name(i) << "=" << (int)(c->inUse_[i] >> 10);
+				}
+				throw MemoryException(msg);
+			}
+		}
+		raiseMark(c->peakTotal_, total);
+		raiseMark(c->peak_[account], atomicAdd(c->inUse_[account], bytes));
+	}
+
+	raiseMark(peak_[account], atomicAdd(inUse_[account], bytes));
+	raiseMark(peakTotal_, atomicAdd(total_, bytes));
+}
+
+void MemAccount::release(int account, long long bytes)
+{
+	Check *c = check_;
+	if (c != 0) {
+		atomicAdd(c->inUse_[account], -bytes);
+		atomicAdd(c->total_, -bytes);
+	}
+	atomicAdd(inUse_[account], -bytes);
+	atomicAdd(total_, -bytes);
+}
+
+long long MemAccount::inUse(int account)
+{
+	return inUse_[account];
+}
+
+long long MemAccount::peak(int account)
+{
+	return peak_[account];
+}
+
+long long MemAccount::peakTotal()
+{
+	return peakTotal_;
+}
+
+void MemAccount::resetPeaks()
+{
+	for (int i = 0; i < TOTAL; i++)
+		peak_[i] = inUse_[i];
+	peakTotal_ = total_;
+}
+
+bool MemAccount::exceeded()
+{
+	return check_ != 0 && check_->exceeded_;
+}
+
+const char *MemAccount::name(int account)
+{
+	ASSERT(account >= 0 && account < TOTAL);
+	return accountNames[account];
+}
+
+void MemAccount::setBudget(long long bytes)
+{
+	budget_ = bytes;
+}
+
+MemAccount::Check::Check()
+{
+	for (int i = 0; i < TOTAL; i++) {
+		inUse_[i] = 0;
+		peak_[i] = 0;
+	}
+	total_ = 0;
+	peakTotal_ = 0;
+	exceeded_ = false;
+	prev_ = check_;
+	check_ = this;
+}
+
+MemAccount::Check::~Check()
+{
+	check_ = prev_;
+}
+
+void MemAccount::Check::resetPeaks()
+{
+	for (int i = 0; i < TOTAL; i++)
+		peak_[i] = inUse_[i];
+	peakTotal_ = total_;
+}
@@ -159,6 +159,191 @@
 
 //	Functions to support the memory tracking calls.
 
+#if UNIX
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL __declspec(thread)
+#endif
+
+// Bytes allocated by the current thread with New, NewI and NewArray.
+// This is maintained in all builds, for statistics (see Stats).
+extern THREAD_LOCAL long long memBytesAllocated;
+
+/*
+	Allocation accounting
+	---------------------
+
+	In all builds, the buffers allocated by Array and SArray are
+	charged to an account identifying the subsystem that allocated
+	them.  Each thread has a current account, which is changed by
+	constructing a MemAccount:
+
+		{
+			MemAccount acc(MemAccount::PRODUCT);
+			... buffers allocated here are charged to PRODUCT ...
+		}
+
+	The bytes in use by each account, and their high-water marks,
+	are maintained for the process.  They're also maintained for each
+	check of a formula (between the construction and destruction of a
+	MemAccount::Check), and a budget can be set for the bytes each
+	check allocates; if it's exceeded, the allocation throws an
+	exception instead of proceeding.  A check applies to the thread
+	that constructed it; other threads working on it must join it
+	(see Check::Use).  Different threads can make different checks at
+	once, and each is charged only for its own allocations.
+*/
+class MemAccount {
+public:
+	enum {
+		OTHER,
+		MODEL,
+		FORMULA,
+		TABLEAU,
+		BUCHI,
+		PRODUCT,
+		DFS,
+		CTL,
+		TOTAL
+	};
+
+	/*	Constructor; makes account current for this thread until
+			destroyed
+	*/
+	MemAccount(int account) {
+		prev_ = current_;
+		current_ = account;
+	}
+	~MemAccount() {
+		current_ = prev_;
+	}
+
+	/*	Get this thread's current account
+	*/
+	static int current() {return current_;}
+
+	/*	Charge an allocation to an account.  Throws an exception if
+			a check is in progress, and its budget would be exceeded.
+			> account					account to charge
+			> bytes						size of allocation
+	*/
+	static void charge(int account, long long bytes);
+
+	/*	Release an allocation
+			> account					account it was charged to
+			> bytes						size of allocation
+	*/
+	static void release(int account, long long bytes);
+
+	/*	Get bytes in use by an account
+	*/
+	static long long inUse(int account);
+
+	/*	Get high-water mark of bytes in use by an account, since the
+			last call to resetPeaks()
+	*/
+	static long long peak(int account);
+
+	/*	Get high-water mark of bytes in use by all accounts
+	*/
+	static long long peakTotal();
+
+	/*	Reset high-water marks to the bytes currently in use
+	*/
+	static void resetPeaks();
+
+	/*	Get name of account
+	*/
+	static const char *name(int account);
+
+	/*	Set budget for each check
+			> bytes						maximum bytes a check may allocate (beyond
+												those in use when it started), or 0 for
+												no limit
+	*/
+	static void setBudget(long long bytes);
+
+	/*	Determine if this thread's current check has exceeded its
+			budget.  The allocation that exceeds it throws an exception,
+			but others (e.g., on other threads) proceed, so threads
+			working on the check should poll this to abandon it.
+			< false if there is no current check
+	*/
+	static bool exceeded();
+
+	class Check;
+
+	/*	Get this thread's current check, or 0 if none
+	*/
+	static Check *check() {return check_;}
+
+	/*	A check in progress.  Constructing one makes it current for
+			this thread until it's destroyed; the budget applies to the
+			bytes allocated (less those released) by the threads it's
+			current for.
+	*/
+	class Check {
+	public:
+		Check();
+		~Check();
+
+		/*	Determine if the budget has been exceeded
+		*/
+		bool exceeded() const {return exceeded_;}
+
+		/*	Get high-water mark of bytes allocated by the check for an
+				account (or in total), since it started or the last call
+				to resetPeaks()
+		*/
+		long long peak(int account) const {return peak_[account];}
+		long long peakTotal() const {return peakTotal_;}
+
+		/*	Reset high-water marks to the bytes currently allocated
+		*/
+		void resetPeaks();
+
+		/*	Makes a check current for this thread until destroyed, so
+				the thread's allocations are charged to it; used by
+				threads that work on a check started by another
+		*/
+		class Use {
+		public:
+			Use(Check *c) {
+				prev_ = check_;
+				check_ = c;
+			}
+			~Use() {
+				check_ = prev_;
+			}
+		private:
+			Check *prev_;
+		};
+
+	private:
+		friend class MemAccount;
+
+		// no copying allowed
+		Check(const Check &s);
+		Check& operator=(const Check &s);
+
+		// bytes allocated (less those released) by the check, for
+		// each account and in total, and their high-water marks
+		volatile long long inUse_[TOTAL];
+		volatile long long peak_[TOTAL];
+		volatile long long total_;
+		volatile long long peakTotal_;
+		// true once the budget has been exceeded
+		volatile bool exceeded_;
+		// check that was current when this one was constructed
+		Check *prev_;
+	};
+
+private:
+	static THREAD_LOCAL int current_;
+	static THREAD_LOCAL Check *check_;
+	int prev_;
+};
+
 #undef _FL_
 #if DEBUG
 #define _FL_     const char *file, int line,
@@ -179,6 +364,7 @@
 template <typename X, typename Y>
 void myNew(_FL_   X *&ptr, Y initValue) {
 	ptr = new X(initValue);
+	memBytesAllocated += sizeof(X);
 #if DEBUG
 	Debug::myNew_(file,line,ptr);
 #endif
@@ -187,6 +373,7 @@ void myNew(_FL_   X *&ptr, Y initValue) {
 template <typename X>
 void myNew(_FL_ 	 X *&ptr) {
 	ptr = new X;
+	memBytesAllocated += sizeof(X);
 	//out << "alloc new item, ptr " << ptr << "\n";
 #if DEBUG
 	Debug::myNew_(file,line,ptr);
@@ -206,6 +393,7 @@ void myDelete(_FL_  X *&ptr) {
 template <typename X>
 void myNewArray(_FL_  X *&ptr, int length) {
 	ptr = new X[length];
+	memBytesAllocated += sizeof(X) * (long long)length;
 #if DEBUG
 	Debug::myNew_(file,line,((char *)ptr) + ARRAY_MOD_VALUE);
 #endif
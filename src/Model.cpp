@@ -26,6 +26,19 @@ void Model::parse(Scanner &scan) {
 			break;
 		}
 
+		// fairness constraint: G F <propvar>
+		if (t.type(TK_G)) {
+			scan.read();
+			scan.read(TK_F);
+			scan.read(t, TK_PROPVAR);
+			if (t.text().equals("_"))
+				throw StringReaderException(scan.lineNumber(),
+					"Missing variable for fairness constraint");
+			int varNum = symbols_.var(t.text(),true);
+			fairness_.add(varNum);
+			continue;
+		}
+
 		bool initial = false;
 
 		if (scan.peek().type(TK_INITIALSTATE)) {		
@@ -34,7 +47,7 @@ void Model::parse(Scanner &scan) {
 		}
 
 		scan.read(t, TK_INT);
-		int num = Utils::parseInt(t.str());
+		int num = Utils::parseInt(t.text());
 		p2(("state name=%d\n",num));
 		
 		int id = stateId(num);
@@ -60,13 +73,14 @@ void Model::parse(Scanner &scan) {
 			if (!first && !t.type(TK_INT)) break;
 			first = false;
 			scan.read(t, TK_INT);
-			int num2 = Utils::parseInt(t.str());
+			int num2 = Utils::parseInt(t.text());
 			p2((" transit to name=%d\n",num2));
 			if (stateId(num2) < 0) {
 				p2(("  doesn't exist, adding it\n"));
 				addState(num2);
 			}
-			addTransition(num,num2);
+			// predecessors are added once the whole model is read
+			states_[id].addTransition(num2);
 		}
 
 		p2((" propVars...\n"));
@@ -77,9 +91,9 @@ void Model::parse(Scanner &scan) {
 			if (!first && !t.type(TK_PROPVAR)) break;
 			first = false;
 			scan.read(t, TK_PROPVAR);
-			if (!t.str().equals("_")) {
+			if (!t.text().equals("_")) {
 				//pr((" searching for %s\n",t.str().s() ));
-				int varNum = symbols_.var(t.str(),true);
+				int varNum = symbols_.var(t.text(),true);
 				//pr(("  returned %d\n",varNum));
 //			int varNum = varToInt(t.str().charAt(0));
 				varsUsed_.set(varNum);
@@ -93,7 +107,7 @@ void Model::parse(Scanner &scan) {
 
 	pt(("verify trans, first=%d, len=%d\n",firstState_,states_.length() ));
 
-	for (int i = 0; i < ids_.length(); i++) {
+	for (int i = 0; i < states_.length(); i++) {
 		//if (!statesUsed_.get(i)) continue;
 		KState &s = states_[i];
 //		if (!s.used()) continue;
@@ -112,31 +126,207 @@ void Model::parse(Scanner &scan) {
 	// if no initial states were defined, make every state
 	// an initial one
 	if (!initDef) {
-		for (int i = 0; i < ids_.length(); i++) 
+		for (int i = 0; i < states_.length(); i++) 
 //			if (statesUsed_.get(i)) {
 			initialStates_.add(stateName(i));
 //			}
 	}
 
+	buildPredecessors();
+
 	p2((" done parsing\n"));
 	p2((" parsed:\n%s",s() ));
 }
 
+void Model::parseDelta(Scanner &scan, OrdSet &changed) {
+#undef p2
+#define p2(a) //pr(a)
+
+	enum {
+		D_INITIAL,
+		D_ADDTRANS,
+		D_REMOVETRANS,
+		D_SETVAR,
+		D_CLEARVAR
+	};
+
+	p2(("Model::parseDelta\n"));
+
+	// the changes, in the order they appear: name of state,
+	// type of change (D_xxx), and state name or variable it applies to
+	Array<int> eState, eType, eArg;
+
+	scan.read(TK_DELTAOP);
+
+	Token t;
+
+	while (true) {
+		scan.peek(t);
+
+		if (t.type(TK_MODELCL)) {
+			scan.read(t);
+			break;
+		}
+
+		int nEdits = eState.length();
+
+		bool initial = false;
+		if (t.type(TK_INITIALSTATE)) {
+			scan.read();
+			initial = true;
+		}
+
+		scan.read(t, TK_INT);
+		int num = Utils::parseInt(t.text());
+		p2(("state name=%d\n",num));
+
+		if (initial) {
+			eState.add(num);
+			eType.add(D_INITIAL);
+			eArg.add(0);
+		}
+
+		while (true) {
+			scan.peek(t);
+			bool neg = false;
+			if (t.type(TK_NEGATION)) {
+				scan.read();
+				neg = true;
+				scan.peek(t);
+			}
+
+			if (t.type(TK_IMPLIES)) {
+				scan.read();
+				scan.read(t, TK_INT);
+				eState.add(num);
+				eType.add(neg ? D_REMOVETRANS : D_ADDTRANS);
+				eArg.add(Utils::parseInt(t.text()));
+				continue;
+			}
+
+			if (!neg && !t.type(TK_PROPVAR))
+				break;
+
+			scan.read(t, TK_PROPVAR);
+			if (t.text().equals("_"))
+				continue;
+			eState.add(num);
+			eType.add(neg ? D_CLEARVAR : D_SETVAR);
+			eArg.add(symbols_.var(t.text(),true));
+		}
+
+		if (eState.length() == nEdits)
+			throw StringReaderException(scan.lineNumber(),"Missing changes for state");
+	}
+
+	// determine the transitions each state being changed will have, and
+	// verify that the model will still be valid before changing anything
+
+	Array<int> names;
+	Array<SmallSet> trans;
+
+	for (int e = 0; e < eState.length(); e++) {
+		int num = eState[e];
+		int k = 0;
+		while (k < names.length() && names[k] != num)
+			k++;
+		if (k == names.length()) {
+			SmallSet st;
+			int id = stateId(num);
+			if (id >= 0)
+				st = states_[id].trans_;
+			names.add(num);
+			trans.add(st);
+		}
+		if (eType[e] == D_ADDTRANS)
+			trans[k].add(eArg[e]);
+		else if (eType[e] == D_REMOVETRANS)
+			trans[k].remove(eArg[e]);
+	}
+
+	for (int k = 0; k < names.length(); k++) {
+		if (trans[k].isEmpty()) {
+			String s("No transitions from state ");
+			s << names[k];
+			throw StringReaderException(scan.lineNumber(),s);
+		}
+	}
+
+	for (int e = 0; e < eState.length(); e++) {
+		if (eType[e] != D_ADDTRANS) continue;
+		int dest = eArg[e];
+		if (stateId(dest) >= 0) continue;
+
+		bool found = false;
+		for (int k = 0; k < names.length(); k++)
+			if (names[k] == dest)
+				found = true;
+		if (!found) {
+			String s("Transition to unknown state: state ");
+			s << eState[e] << " to " << dest;
+			throw StringReaderException(scan.lineNumber(),s);
+		}
+	}
+
+	// apply the changes
+
+	for (int k = 0; k < names.length(); k++) {
+		if (stateId(names[k]) < 0)
+			changed.add(addState(names[k]));
+	}
+
+	for (int e = 0; e < eState.length(); e++) {
+		int num = eState[e];
+		int arg = eArg[e];
+		int id = stateId(num);
+		KState &st = states_[id];
+
+		switch (eType[e]) {
+			case D_INITIAL:
+				setInitialState(num);
+				break;
+			case D_ADDTRANS:
+				if (!st.trans_.contains(arg)) {
+					addTransition(num, arg);
+					changed.add(id);
+				}
+				break;
+			case D_REMOVETRANS:
+				if (st.trans_.contains(arg)) {
+					removeTransition(num, arg);
+					changed.add(id);
+				}
+				break;
+			case D_SETVAR:
+				varsUsed_.set(arg);
+				if (!st.pv_.get(arg)) {
+					addPropVar(num, arg);
+					changed.add(id);
+				}
+				break;
+			case D_CLEARVAR:
+				if (st.pv_.get(arg)) {
+					clearPropVar(num, arg);
+					changed.add(id);
+				}
+				break;
+		}
+	}
+
+	p2((" applied delta:\n%s",s() ));
+}
+
 int Model::addState(int name) {
 	KState st;
 
 	ASSERT(stateId(name) < 0);
 
-	int id = ids_.add(0);
-	ids_.set(id, id);
-
+	int id = states_.length();
 	states_.add(st);
 
 	names_.add(name);
 
-	char work[20];
-	Utils::intToStr(name,work);
-	tbl_.set(work, &ids_[id]);
+	tbl_.set(name, id);
 
 //	states_.add(st,number);
 //	if (firstState_ < 0 || firstState_ > number)
@@ -158,7 +348,8 @@ void Model::print() const {
 		else
 			Cout << ' ';
 
-		Cout << fmt(name,STW) << ":";
+		Utils::printField(name,STW);
+		Cout << ':';
 		int j = degree(name);
 		int tot = 0;
 		for (int k = 0; k < j; k++) {
@@ -167,7 +358,7 @@ void Model::print() const {
 				Cout << "\n";
 				Utils::pad(STW+1);
 			}
-			Cout << fmt(next(name,k),STW);
+			Utils::printField(next(name,k),STW);
 		}
 		Utils::pad((MAX_TRANS - tot)*STW+1);
 
@@ -177,6 +368,8 @@ void Model::print() const {
 		}
 		Cout << "\n";
 	}
+	for (int i = 0; i < fairness_.length(); i++)
+		Cout << " G F " << symbols_.var(fairness_[i]) << "\n";
 }
 
 void Model::clear() {
@@ -185,7 +378,7 @@ void Model::clear() {
 	initialStates_.clear();
 	tbl_.clear();
 	names_.clear();
-	ids_.clear();
+	fairness_.clear();
 }
 
 #if DEBUG
@@ -206,9 +399,7 @@ int Model::stateName(int id) const
 
 int Model::stateId(int name, bool mustExist) const
 {
-	char work[20];
-	Utils::intToStr(name, work);
-	int *ptr = (int *)tbl_.get(work);
+	int *ptr = tbl_.find(name);
 	if (ptr == 0) {
 #if DEBUG
 		ASSERT2(!mustExist, "stateId called with undefined state");
@@ -229,14 +420,454 @@ void Model::addTransition(int src, int dest) {
 	ASSERT(srcId >= 0);
 	p2((" srcId=%d\n",srcId));
 	states_[srcId].addTransition(dest);
+	states_[stateId(dest,true)].preds_.add(src);
 	p2((" done add trans\n"));
 }
 
+/*	Sort an array of integers into increasing order
+		> a								array to sort
+		> work						work array, same length as a
+		> start						first index of range to sort
+		> end							index following range to sort
+*/
+static void mergeSort(Array<int> &a, Array<int> &work, int start, int end)
+{
+	if (end - start < 2) return;
+	int mid = (start + end) / 2;
+	mergeSort(a, work, start, mid);
+	mergeSort(a, work, mid, end);
+
+	int i = start, j = mid, k = start;
+	while (k < end) {
+		if (j == end || (i < mid && a[i] <= a[j]))
+			work.set(k++, a[i++]);
+		else
+			work.set(k++, a[j++]);
+	}
+	for (k = start; k < end; k++)
+		a.set(k, work[k]);
+}
+
+void Model::buildPredecessors() {
+	// visit the states in order of increasing name, so each is added
+	// to the end of its successors' (sorted) predecessor lists
+	Array<int> order(names_);
+	Array<int> work(names_);
+	mergeSort(order, work, 0, order.length());
+
+	for (int i = 0; i < states_.length(); i++)
+		states_[i].preds_.clear();
+
+	for (int i = 0; i < order.length(); i++) {
+		int src = order[i];
+		const SmallSet &trans = states_[stateId(src)].trans_;
+		for (int j = 0; j < trans.length(); j++)
+			states_[stateId(trans[j],true)].preds_.add(src);
+	}
+}
+
+void Model::removeTransition(int src, int dest) {
+	states_[stateId(src,true)].trans_.remove(dest);
+	states_[stateId(dest,true)].preds_.remove(src);
+}
+
 void Model::addPropVar(int state, int var) {
 	int id = stateId(state, true);
 	states_[id].setPropVar(var);
 }
 
+void Model::clearPropVar(int state, int var) {
+	int id = stateId(state, true);
+	states_[id].pv_.set(var, false);
+}
+
 bool Model::propVar(int stateName, int vn) const {
 		return states_[stateId(stateName,true)].pv_.get(vn);
 }
+
+bool Model::stutterQuotient(const OrdSet &vars, Model &q,
+	Array<int> *classOf) const
+{
+#undef p2
+#define p2(a) //pr(a)
+
+	int n = states();
+
+	// successors of each state, by id
+	Array<int> succ;
+	Array<int> start;
+	for (int i = 0; i < n; i++) {
+		start.add(succ.length());
+		const SmallSet &tr = states_[i].trans_;
+		for (int j = 0; j < tr.length(); j++)
+			succ.add(stateId(tr[j]));
+	}
+	start.add(succ.length());
+
+	// start by distinguishing states only by the variables, splitting
+	// the classes by one variable at a time
+	Array<int> block;
+	for (int i = 0; i < n; i++)
+		block.add(0);
+	int nBlocks = 1;
+	for (int j = 0; j < vars.length(); j++) {
+		HashMap<int, int> ids;
+		nBlocks = 0;
+		for (int i = 0; i < n; i++) {
+			int key = block[i] * 2 + (states_[i].pv_.get(vars[j]) ? 1 : 0);
+			int *id = ids.find(key);
+			if (id == 0) {
+				ids.set(key, nBlocks);
+				block.set(i, nBlocks++);
+			} else
+				block.set(i, *id);
+		}
+	}
+	if (n == 0)
+		nBlocks = 0;
+
+	// refine the partition until no class is split
+	BitStore divergent;
+	while (true) {
+		int nb = refineStutter(succ, start, block, divergent);
+		p2((" refined %d classes to %d\n",nBlocks,nb));
+		if (nb == nBlocks) break;
+		nBlocks = nb;
+	}
+
+	q.clear();
+	if (nBlocks == n)
+		return false;
+
+	// name each class after its first state
+	Array<int> rep;
+	for (int b = 0; b < nBlocks; b++)
+		rep.add(-1);
+	for (int i = 0; i < n; i++) {
+		int b = block[i];
+		if (rep[b] >= 0) continue;
+		rep.set(b, i);
+		int name = stateName(i);
+		q.addState(name);
+		q.states_[q.stateId(name)].pv_ = states_[i].pv_;
+	}
+
+	// add a transition for each move to a different class, and one
+	// from each class to itself if its states can stay within it
+	for (int i = 0; i < n; i++) {
+		int src = stateName(rep[block[i]]);
+		SmallSet &tr = q.states_[q.stateId(src)].trans_;
+		if (divergent[i] && !tr.contains(src))
+			q.addTransition(src, src);
+		for (int j = start[i]; j < start[i+1]; j++) {
+			int dest = stateName(rep[block[succ[j]]]);
+			if (dest != src && !tr.contains(dest))
+				q.addTransition(src, dest);
+		}
+	}
+
+	const OrdSet &init = initialStates();
+	for (int i = 0; i < init.length(); i++)
+		q.setInitialState(stateName(rep[block[stateId(init[i])]]));
+
+	if (classOf != 0) {
+		classOf->clear();
+		for (int i = 0; i < n; i++)
+			classOf->add(stateName(rep[block[i]]));
+	}
+	return true;
+}
+
+int Model::stutterPath(const Array<int> &classOf, const Array<int> &qPath,
+	int qLoop, Array<int> &path) const
+{
+	ASSERT(qLoop >= 0 && qLoop < qPath.length());
+
+	// moves within a class don't change the values of the variables,
+	// so only the sequence of classes has to be followed
+	Array<int> cls;
+	int loop = -1;
+	for (int i = 0; i < qPath.length(); i++) {
+		if (cls.isEmpty() || cls.last() != qPath[i])
+			cls.add(qPath[i]);
+		if (i == qLoop)
+			loop = cls.length() - 1;
+	}
+	while (cls.length() - loop > 1 && cls.last() == cls[loop])
+		cls.pop();
+
+	Array<int> ids;
+	const OrdSet &init = initialStates();
+	for (int i = 0; i < init.length(); i++) {
+		int s = stateId(init[i]);
+		if (classOf[s] == cls[0]) {
+			ids.add(s);
+			break;
+		}
+	}
+	ASSERT(!ids.isEmpty());
+
+	for (int i = 1; i <= loop; i++)
+		stutterMove(classOf, ids, cls[i]);
+
+	int rep = -1;
+	if (cls.length() - loop == 1) {
+
+		// the path stays within the class forever; find a cycle within
+		// it, by a depth first search from the last state
+
+		int first = ids.length() - 1;
+		int c = classOf[ids[first]];
+
+		// position of each state on the dfs stack, or -1 if finished
+		HashMap<int, int> pos;
+		Array<int> edge;
+		pos.set(ids[first], first);
+		edge.add(0);
+
+		while (rep < 0) {
+			ASSERT(!edge.isEmpty());
+			int s = ids.last();
+			const SmallSet &tr = states_[s].trans_;
+			int e = edge.last();
+			if (e == tr.length()) {
+				pos.set(s, -1);
+				ids.pop();
+				edge.pop();
+				continue;
+			}
+			edge.set(edge.length() - 1, e + 1);
+			int t = stateId(tr[e]);
+			if (classOf[t] != c)
+				continue;
+			int *p = pos.find(t);
+			if (p == 0) {
+				pos.set(t, ids.length());
+				ids.add(t);
+				edge.add(0);
+			} else if (*p >= 0)
+				rep = *p;
+		}
+	} else {
+
+		// follow the cycle of classes until it's begun from a state it
+		// was begun from before
+
+		HashMap<int, int> begun;
+		while (true) {
+			int *p = begun.find(ids.last());
+			if (p != 0) {
+				rep = *p;
+				ids.pop();
+				break;
+			}
+			begun.set(ids.last(), ids.length() - 1);
+			for (int i = loop + 1; i <= cls.length(); i++)
+				stutterMove(classOf, ids, cls[i < cls.length() ? i : loop]);
+		}
+	}
+
+	path.clear();
+	for (int i = 0; i < ids.length(); i++)
+		path.add(stateName(ids[i]));
+	return rep;
+}
+
+void Model::stutterMove(const Array<int> &classOf, Array<int> &path,
+	int target) const
+{
+	// breadth first search within the class, recording the state each
+	// was reached from
+	int start = path.last();
+	int c = classOf[start];
+	HashMap<int, int> from;
+	Array<int> queue;
+	from.set(start, -1);
+	queue.add(start);
+
+	for (int i = 0; i < queue.length(); i++) {
+		int s = queue[i];
+		const SmallSet &tr = states_[s].trans_;
+		for (int j = 0; j < tr.length(); j++) {
+			int t = stateId(tr[j]);
+			if (classOf[t] == target) {
+				Array<int> steps;
+				steps.add(t);
+				for (int u = s; u != start; u = *from.find(u))
+					steps.add(u);
+				for (int k = steps.length() - 1; k >= 0; k--)
+					path.add(steps[k]);
+				return;
+			}
+			if (classOf[t] != c || from.find(t) != 0)
+				continue;
+			from.set(t, s);
+			queue.add(t);
+		}
+	}
+	// the classes are stutter bisimilar, so this can't happen
+	ASSERT(false);
+}
+
+/*	What distinguishes a state from others in a round of refining the
+		stutter partition: its class, whether it has paths that stay
+		within it, and the other classes it can move to
+*/
+class StutterKey {
+public:
+	StutterKey() : block(0), divergent(false), exits(0) {}
+	StutterKey(int b, bool d, const OrdSet *e)
+	: block(b), divergent(d), exits(e) {}
+	int block;
+	bool divergent;
+	const OrdSet *exits;
+};
+
+template <>
+class HashKey<StutterKey> {
+public:
+	static unsigned hash(const StutterKey &k) {
+		unsigned h = Utils::hashInt(k.block * 2 + (k.divergent ? 1 : 0));
+		for (int i = 0; i < k.exits->length(); i++)
+			h = Utils::hashInt(h ^ k.exits->itemAt(i));
+		return h;
+	}
+	static bool equal(const StutterKey &a, const StutterKey &b) {
+		return a.block == b.block && a.divergent == b.divergent
+			&& (a.exits == b.exits || a.exits->equals(*b.exits));
+	}
+};
+
+/*	Uses Tarjan's algorithm, iteratively, as in CTLCheck::findFairPaths,
+		on the moves within classes.  Components are completed in reverse
+		topological order, so when one is completed, the classes that can
+		be reached from every component it has moves to are known, as is
+		whether those components have paths staying within the class.
+*/
+int Model::refineStutter(const Array<int> &succ, const Array<int> &start,
+	Array<int> &block, BitStore &divergent) const
+{
+	int n = states();
+	divergent.clear();
+
+	// order in which states were discovered, or -1 if not yet
+	Array<int> index;
+	// lowest index reachable from state through its subtree
+	Array<int> low;
+	// component state belongs to, or -1 if not yet assigned
+	Array<int> comp;
+	index.ensureCapacity(n, false);
+	low.ensureCapacity(n, false);
+	comp.ensureCapacity(n, false);
+	for (int i = 0; i < n; i++) {
+		index.add(-1);
+		low.add(0);
+		comp.add(-1);
+	}
+
+	// for each component, the other classes its states can move to,
+	// possibly after moving within their own
+	Array<OrdSet> exits;
+	int counter = 0;
+
+	Stack<int> sccStack;
+	BitStore onStack;
+
+	// dfs stack of states, and the next transition to follow from each
+	Stack<int> callStack;
+	Stack<int> edgeStack;
+
+	Array<int> members;
+
+	for (int root = 0; root < n; root++) {
+		if (index[root] >= 0) continue;
+
+		index.set(root, counter);
+		low.set(root, counter);
+		counter++;
+		sccStack.push(root);
+		onStack.set(root);
+		callStack.push(root);
+		edgeStack.push(0);
+
+		while (!callStack.isEmpty()) {
+			int s = callStack.peek();
+			int e = start[s] + edgeStack.peek();
+
+			if (e < start[s+1]) {
+				edgeStack.set(edgeStack.length()-1, e+1 - start[s]);
+				int s2 = succ[e];
+				if (block[s2] != block[s]) continue;
+				if (index[s2] < 0) {
+					index.set(s2, counter);
+					low.set(s2, counter);
+					counter++;
+					sccStack.push(s2);
+					onStack.set(s2);
+					callStack.push(s2);
+					edgeStack.push(0);
+				} else if (onStack[s2])
+					low.set(s, minVal(low[s], index[s2]));
+				continue;
+			}
+
+			callStack.pop();
+			edgeStack.pop();
+			if (!callStack.isEmpty()) {
+				int p = callStack.peek();
+				low.set(p, minVal(low[p], low[s]));
+			}
+			if (low[s] != index[s]) continue;
+
+			// s is the root of a component; pop its members
+			int c = exits.length();
+			members.clear();
+			while (true) {
+				int m = sccStack.pop();
+				onStack.set(m, false);
+				comp.set(m, c);
+				members.add(m);
+				if (m == s) break;
+			}
+
+			// its states can stay within the class forever if it is
+			// non-trivial, or leads to a component whose states can
+			OrdSet ex;
+			bool div = members.length() > 1;
+			for (int i = 0; i < members.length(); i++) {
+				int m = members[i];
+				for (int j = start[m]; j < start[m+1]; j++) {
+					int t = succ[j];
+					if (block[t] != block[m])
+						ex.add(block[t]);
+					else if (t == m)
+						div = true;
+					else if (comp[t] != c) {
+						ex.include(exits[comp[t]]);
+						if (divergent[t])
+							div = true;
+					}
+				}
+			}
+			for (int i = 0; i < members.length(); i++)
+				divergent.set(members[i], div);
+			exits.add(OrdSet());
+			exits.last().swap(ex);
+		}
+	}
+
+	// states remain in the same class only if they were in the same
+	// class before, and agree on the above
+	HashMap<StutterKey, int> ids;
+	int nBlocks = 0;
+	for (int i = 0; i < n; i++) {
+		StutterKey key(block[i], divergent[i], &exits[comp[i]]);
+		int *id = ids.find(key);
+		if (id == 0) {
+			ids.set(key, nBlocks);
+			block.set(i, nBlocks++);
+		} else
+			block.set(i, *id);
+	}
+	return nBlocks;
+}
@@ -15,8 +15,55 @@ public:
 	*/
 	void clear();
 
+	/*	Parse a model.  It has the form
+
+				{ <entry>* }
+
+			where each entry is either a state
+
+				[>] <state> <state>+ <propvar>+
+
+			(its name, the states it has transitions to, and the
+			prop. vars true in it; '_' if there are none), or a
+			fairness constraint
+
+				G F <propvar>
+
+			which restricts the paths considered by CTL path quantifiers
+			to those that visit states where the variable is true
+			infinitely often.
+
+			> scanner
+	*/
 	void parse(Scanner &scanner);
 
+	/*	Parse a set of changes to the model, and apply them.
+			The changes have the form
+
+				+{ <entry>* }
+
+			where each entry is
+
+				[>] <state> <edit>*
+
+			and each edit is one of
+
+				-> <state>				add transition
+				! -> <state>			remove transition
+				<propvar>					set prop. var. true
+				! <propvar>				set prop. var. false
+
+			A '>' makes the state an initial state.  States that don't
+			exist are added.  Every state must still have at least
+			one transition after the changes are applied; if not, an
+			exception is thrown and the model is left unchanged.
+
+			> scanner
+			> changed					ids of states whose transitions or prop. vars
+												changed (including new states) are added to this
+	*/
+	void parseDelta(Scanner &scanner, OrdSet &changed);
+
 	/*	Add a state to the model
 			> name						name of state to add
 			< id of state
@@ -35,6 +82,12 @@ public:
 	*/
 	void addPropVar(int state, int var);
 
+	/*	Set a propositional variable false in a state
+			> state						name of state
+			> var							variable to set false
+	*/
+	void clearPropVar(int state, int var);
+
 	/*	Determine number of transitions from a state
 			> src							name of state
 	*/
@@ -52,12 +105,35 @@ public:
 		return states_[currentId].trans_.itemAt(neighborInd);
 	}
 
+	/*	Determine number of transitions to a state
+			> dest						name of state
+	*/
+	int predDegree(int dest) const {
+		return states_[stateId(dest,true)].preds_.length();
+	}
+
+	/*	Get previous state
+			> current					name of current state
+			> neighborInd			index of neighbor in list (0..predDegree-1)
+			< name of previous state
+	*/
+	int prev(int current, int neighborInd) const {
+		int currentId = stateId(current);
+		return states_[currentId].preds_.itemAt(neighborInd);
+	}
+
 	/*	Add a transition from one state to another
 			> src							name of source state
 			> dest						name of destination state
 	*/
 	void addTransition(int src, int dest);
 
+	/*	Remove a transition, if it exists
+			> src							name of source state
+			> dest						name of destination state
+	*/
+	void removeTransition(int src, int dest);
+
 	void print() const;
 #if DEBUG
 	const char *s() const;
@@ -114,6 +190,55 @@ public:
 	int stateId(int name, bool mustExist = false) const;
 
 	const Array<int> &getNames() {return names_;}
+
+	/*	Determine number of fairness constraints
+	*/
+	int fairnessConstraints() const {return fairness_.length();}
+
+	/*	Get a fairness constraint
+			> i								index of constraint (0..fairnessConstraints()-1)
+			< id of variable that must be true infinitely often
+	*/
+	int fairnessVar(int i) const {return fairness_[i];}
+
+	/*	Construct the quotient of the model under divergence-sensitive
+			stutter bisimulation, with respect to some variables.  Two
+			states are equivalent if they agree on the variables, each can
+			match the other's moves to a different class by first moving
+			within its own class, and either both or neither have paths
+			that stay within their class forever.  The quotient has a
+			state for each class, named after its first state, with a
+			transition to itself if the class has such paths.
+
+			Equivalent states satisfy the same LTL formulas without X
+			over the variables; see Baier & Katoen, 'Principles of Model
+			Checking', section 7.8.  Fairness constraints are ignored.
+
+			> vars						ids of variables to distinguish states by
+			> q								where to store quotient; it should use
+												the same symbol table as this model
+			> classOf					if not null, the name of the quotient state
+												each state (by id) belongs to is stored here
+			< true if the quotient has fewer states than the model
+	*/
+	bool stutterQuotient(const OrdSet &vars, Model &q,
+		Array<int> *classOf = 0) const;
+
+	/*	Find a path of the model that's equivalent to a path of its
+			stuttering quotient, in that it passes through the same
+			sequence of classes (staying within each for one or more
+			steps); so it satisfies the same LTL formulas without X
+			> classOf					class of each state, from stutterQuotient()
+			> qPath						names of the quotient states along a path
+												of the quotient
+			> qLoop						index of the state the quotient path repeats
+												from
+			> path						names of the model states along the path
+												are stored here
+			< index of the state the path repeats from
+	*/
+	int stutterPath(const Array<int> &classOf, const Array<int> &qPath,
+		int qLoop, Array<int> &path) const;
 private:
 
 	class KState {
@@ -139,9 +264,50 @@ private:
 		BitStore pv_;
 		// list of state names this state can transition to.
 		// Note that these are NAMES and not IDS.
-		OrdSet trans_;
+		SmallSet trans_;
+		// names of states that can transition to this one
+		SmallSet preds_;
+
+		void swap(KState &s) {
+			pv_.swap(s.pv_);
+			trans_.swap(s.trans_);
+			preds_.swap(s.preds_);
+		}
+		friend void moveValue(KState &dest, KState &src) {
+			dest.swap(src);
+		}
 	};
 
+	/*	Refine a partition of the states, by splitting each class
+			according to the classes its states can move to (after
+			moving within it), and whether they have paths that stay
+			within it forever
+			> succ						ids of successors of each state, with state i's
+												from succ[start[i]] to succ[start[i+1]-1]
+			> start
+			> block						class of each state; replaced by the new class
+			> divergent				where to store flags of states with paths
+												that stay within their (original) class
+			< number of classes
+	*/
+	int refineStutter(const Array<int> &succ, const Array<int> &start,
+		Array<int> &block, BitStore &divergent) const;
+
+	/*	Extend a path to a state of another class, by a shortest path
+			that stays within the class of its last state until then
+			> classOf					class of each state, by id
+			> path						ids of states along path; extended
+			> target					class to move to
+	*/
+	void stutterMove(const Array<int> &classOf, Array<int> &path,
+		int target) const;
+
+	/*	Construct the states' predecessor lists from their transitions
+			(replacing any existing lists); used after parsing, instead of
+			adding each transition's predecessor as it is read
+	*/
+	void buildPredecessors();
+
 	// array of states
 	Array<KState> states_;
 
@@ -153,13 +319,13 @@ private:
 	// initial states
 	OrdSet initialStates_;
 
-	// hash table containing strings of state names, with pointers to
-	// state ids
-	HashTable tbl_;
+	// maps state names to state ids
+	HashMap<int, int> tbl_;
 
 	// names associated with each state
 	Array<int> names_;
-	// ids of each state; these are pointed to by the hash table entries
-	SArray<int> ids_;
+
+	// variables of fairness constraints (G F <var>)
+	OrdSet fairness_;
 };
 #endif // _MODEL
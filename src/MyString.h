@@ -1,3 +1,5 @@
+#include <cstring>
+
 // sources and sinks:  base class for reading, writing
 // data to or from files, strings, stdout, cout, etc.
 class Sink {
@@ -9,6 +11,20 @@ public:
 	virtual Sink& operator << (char c) = 0;
 	virtual Sink& operator << (double d) = 0;
 	virtual Sink& operator << (float f) = 0;
+
+	/*	Write a sequence of characters
+			> s								characters
+			> len							number of characters
+	*/
+	virtual void write(const char *s, int len) {
+		for (int i = 0; i < len; i++)
+			*this << s[i];
+	}
+
+	/*	Send any buffered output to its destination
+	*/
+	virtual void flush() {}
+
 	virtual ~Sink() {}
 };
 class Source {
@@ -62,6 +78,28 @@ public:
 		return *this;
 	}
 #endif
+#if HAS_MOVE
+	String(const String &s) = default;
+	String& operator=(const String &s) = default;
+	String(String &&s) {
+		construct();
+		swap(s);
+	}
+	String& operator=(String &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
+
+	/*	Exchange contents with another string, without copying
+	*/
+	void swap(String &s) {
+		charArray_.swap(s.charArray_);
+	#if DEBUG
+		swapVal(mutable_, s.mutable_);
+		swapVal(lock_, s.lock_);
+	#endif
+	}
 private:
 	void construct() {
 		#if DEBUG
@@ -224,6 +262,7 @@ public:
 	virtual Sink& operator << (char c);
 	virtual Sink& operator << (double d);
 	virtual Sink& operator << (float f);
+	virtual void write(const char *s, int len) {append(s, 0, len);}
 private:
 	void verifyAbstract() const
 #if !DEBUG
@@ -298,6 +337,35 @@ public:
 };
 ostream &operator << (ostream &sout, const String &s);
 
+inline void moveValue(String &dest, String &src) {
+	dest.swap(src);
+}
+
+/*	Reference to characters owned by some other object (not necessarily
+		zero-terminated); for looking up strings without constructing a
+		String
+*/
+class StrRef {
+public:
+	StrRef(const char *chars, int length) : chars_(chars), length_(length) {}
+	StrRef(const String &s) : chars_(s.chars()), length_(s.length()) {}
+
+	const char *chars() const {return chars_;}
+	int length() const {return length_;}
+
+	bool equals(const String &s) const {
+		return s.length() == length_
+			&& memcmp(s.chars(), chars_, length_) == 0;
+	}
+	bool equals(const char *s) const {
+		return strncmp(s, chars_, length_) == 0 && s[length_] == 0;
+	}
+
+private:
+	const char *chars_;
+	int length_;
+};
+
 // Non-class versions of some utility functions:
 #define stringLength(a) String::strLength(a)
 #define strCopy(dest,src) String::stringCopy(dest,src,-1)
@@ -92,3 +92,54 @@ void OrdSet::calcUnion(const OrdSet &s0, const OrdSet &s1, OrdSet &dest)
 	}
 }
 
+
+bool SmallSet::contains(int n, int &loc) const
+{
+	loc = -1;
+	for (int i = 0; i < length(); i++) {
+		if (itemAt(i) > n)
+			break;
+		if (itemAt(i) == n) {
+			loc = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void SmallSet::add(int n) {
+	// adding past the end is common (sets built in order), so check
+	// for it first
+	int len = length();
+	if (len == 0 || itemAt(len-1) < n) {
+		insert(len,n);
+		return;
+	}
+	int i = 0;
+	while (i < length()) {
+		if (itemAt(i) == n) return;
+		if (itemAt(i) > n) break;
+		i++;
+	}
+	insert(i,n);
+}
+
+void SmallSet::remove(int n) {
+	int loc;
+	if (contains(n,loc))
+		SmallArray<int, 5>::remove(loc);
+}
+
+#if DEBUG
+String SmallSet::debInfo() const
+{
+	String s("(");
+	for (int i = 0; i < length(); i++) {
+		if (i != 0)
+			s << " ";
+		s << itemAt(i);
+	}
+	s << ")";
+	return s;
+}
+#endif
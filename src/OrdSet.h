@@ -4,6 +4,21 @@
 //	Ordered set of integers
 class OrdSet : private Array<int> {
 public:
+	OrdSet() {}
+#if HAS_MOVE
+	OrdSet(const OrdSet &s) = default;
+	OrdSet& operator=(const OrdSet &s) = default;
+	OrdSet(OrdSet &&s) {swap(s);}
+	OrdSet& operator=(OrdSet &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
+
+	/*	Exchange contents with another set, without copying
+	*/
+	void swap(OrdSet &s) {Array<int>::swap(s);}
+
 	void clear() {Array<int>::clear();}
 	void add(int n);
 	void remove(int n);
@@ -34,4 +49,43 @@ public:
 #endif
 };
 
+inline void moveValue(OrdSet &dest, OrdSet &src) {
+	dest.swap(src);
+}
+
+/*	Ordered set of integers, with room for a few items within the object
+		itself (see SmallArray); for the many small per-state sets, such as
+		a model state's transitions
+*/
+class SmallSet : private SmallArray<int, 5> {
+public:
+	SmallSet() {}
+
+	/*	Exchange contents with another set
+	*/
+	void swap(SmallSet &s) {SmallArray<int, 5>::swap(s);}
+
+	void clear() {SmallArray<int, 5>::clear();}
+	void add(int n);
+	void remove(int n);
+
+	int length() const {return SmallArray<int, 5>::length();}
+	int itemAt(int pos) const {return SmallArray<int, 5>::itemAt(pos);}
+	int operator[](int i) const {return itemAt(i);}
+
+	bool isEmpty() const {return (length() == 0);}
+	bool contains(int n, int &loc) const;
+	bool contains(int n) const {
+		int loc;
+		return contains(n, loc);
+	}
+#if DEBUG
+	String debInfo() const;
+#endif
+};
+
+inline void moveValue(SmallSet &dest, SmallSet &src) {
+	dest.swap(src);
+}
+
 #endif // _ORDSET
@@ -14,11 +14,35 @@ public:
 	SArray(const SArray &s);
 	// assignment operator
 	SArray& operator=(const SArray &s);
+#if HAS_MOVE
+	// move constructor
+	SArray(SArray &&s) {
+		construct();
+		pageSize_ = s.pageSize_;
+		swap(s);
+	}
+	// move assignment operator
+	SArray& operator=(SArray &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
 	// initializer
 private:
 	void construct();
 	// --------------------------------
 public:
+	/*	Exchange contents with another array, without copying items
+	*/
+	void swap(SArray &s) {
+		pagePtrs_.swap(s.pagePtrs_);
+		valid_.swap(s.valid_);
+		recycleBin_.swap(s.recycleBin_);
+		swapVal(lastItem_, s.lastItem_);
+		swapVal(pageSize_, s.pageSize_);
+		swapVal(account_, s.account_);
+	}
+
 	/*	Get item
 			> id							id of item
 	*/
@@ -85,6 +109,12 @@ private:
 		slot = id % pageSize_;
 	}
 
+	/*	Allocate a page, charging it to the account of the existing
+			pages (or the current account, if there are none)
+			< new page
+	*/
+	T *newPage();
+
 	// pointers to item pages
 	Array<void *> pagePtrs_;
 
@@ -99,11 +129,28 @@ private:
 
 	// # items in each page
 	int pageSize_;
+
+	// account pages are charged to (see MemAccount)
+	int account_;
 };
 
+template <typename T>
+inline void moveValue(SArray<T> &dest, SArray<T> &src) {
+	dest.swap(src);
+}
+
 template<typename T>
 void SArray<T>::construct() {
 	lastItem_ = -1;
+	account_ = MemAccount::OTHER;
+}
+
+template<typename T>
+T *SArray<T>::newPage() {
+	if (pagePtrs_.isEmpty())
+		account_ = MemAccount::current();
+	MemAccount::charge(account_, sizeof(T) * (long long)pageSize_);
+	return new T[pageSize_];
 }
 
 template<typename T> 
@@ -122,6 +169,8 @@ SArray<T>::~SArray()
 
 template<typename T> 
 void SArray<T>::clear() {
+	MemAccount::release(account_,
+		sizeof(T) * (long long)pageSize_ * pagePtrs_.length());
 	while (!pagePtrs_.isEmpty()) {
 		T *pg = (T *)pagePtrs_.pop();
 		delete [] pg;
@@ -142,8 +191,7 @@ int SArray<T>::add(const T &item, int id)
 		calcPageAndSlot(id, page, slot);
 
 		while (page >= pagePtrs_.length()) {
-			T *newPage = new T[pageSize_];
-			pagePtrs_.add((int *)newPage);
+			pagePtrs_.add((int *)newPage());
 		}
 		valid_.set(id);
 		set(id, item);
@@ -174,8 +222,7 @@ int SArray<T>::alloc(const T &item)
 	calcPageAndSlot(id, page, slot);
 
 	if (page >= pagePtrs_.length()) {
-		T *newPage = new T[pageSize_];
-		pagePtrs_.add((int *)newPage);
+		pagePtrs_.add((int *)newPage());
 	}
 	valid_.set(id);
 	set(id, item);
@@ -223,11 +270,11 @@ SArray<T>& SArray<T>::operator=(const SArray<T> &s)
 		lastItem_ = s.lastItem_;
 
 		for (int i = 0; i < s.pagePtrs_.length(); i++) {
-			T *newPage = new T[pageSize_];
+			T *page = newPage();
 			T *srcPage = (T *)s.pagePtrs_.itemAt(i);
 			for (int j = 0; j < pageSize_; j++)
-				newPage[j] = srcPage[j];
-			pagePtrs_.add(newPage);
+				page[j] = srcPage[j];
+			pagePtrs_.add(page);
 		}
 	}
 	return *this;
@@ -67,6 +67,8 @@ ErrorRecord &ErrorRecord::operator =(const ErrorRecord &s) {
 void Scanner::LineBuffer::construct() {
 	CONSTRUCT();
 	lineNumber_ = 0;
+	text_ = "";
+	length_ = 0;
 }
 
 Scanner::Scanner(int ppOpts, DFA *dfa)
@@ -118,6 +120,10 @@ Scanner::~Scanner() {
 		LineBuffer *lb = lineBuffers_.itemAt(i);
 		Delete(lb);
 	}
+	while (!mappedFiles_.isEmpty()) {
+		MappedFile *mf = mappedFiles_.pop();
+		Delete(mf);
+	}
 #if _WITHPP
 	Delete(pp_);
 #endif
@@ -125,6 +131,12 @@ Scanner::~Scanner() {
 }
 
 Token Scanner::peek()
+{
+	fillLookahead();
+	return nextToken_;
+}
+
+void Scanner::fillLookahead()
 {
 	// Read next token if we don't have one, or if we're
 	// supposed to skip the one we've got.
@@ -149,12 +161,12 @@ Token Scanner::peek()
 		}
 	}
 	p2(("  peek, returning %s\n",nextToken_.debInfo().chars() ));
-	return nextToken_;	
 }
 
 bool Scanner::peek(Token &token)
 {
-	token = peek();
+	fillLookahead();
+	token = nextToken_;
 	return !token.type(T_EOF);
 }
 
@@ -168,14 +180,15 @@ bool Scanner::read(Token &token)
 
 		// if we have another token buffered, use it
 		if (nextToken_.type() != T_EOF) {
-			token = nextToken_;
+			token.swap(nextToken_);
 			// clear buffered token 
 			nextToken_.set(T_EOF);
 		} else {
 			read_(token);
 		}
-		for (int i = 0; i < token.str().length(); i++) {
-			char c = token.str().charAt(i);
+		StrRef text = token.text();
+		for (int i = 0; i < text.length(); i++) {
+			char c = text.chars()[i];
 			col_++;
 			if (c == '\n') {
 				line_++;
@@ -193,17 +206,12 @@ bool Scanner::read(Token &token)
 */
 bool Scanner::startTokenizer() {
 	while (true) {
-		if (
-				reader_.source() != 0
- 		 && reader_.source()->eof()
-		) {
+		if (reader_.active() && reader_.atEnd()) {
 				flushErrors();
 				reader_.close();
-				// close queued reader in case it was the one being read from
-				qReader_.close();
 		}
 
-		if ( !reader_.source()) {
+		if (!reader_.active()) {
 			if (!readers_.isEmpty()) {
 				reader_ = readers_.pop();
 				if (echo()) {
@@ -216,14 +224,17 @@ bool Scanner::startTokenizer() {
 
 			if (fileQueue_.length() > fileNumber_) {
 				String &path = fileQueue_[fileNumber_++];
-				qReader_.open(path.chars());
-				includeSource(qReader_,&path);
+				MappedFile *mf;
+				New(mf);
+				mappedFiles_.add(mf);
+				mf->open(path);
+				includeText(mf->chars(), mf->length(), &path);
 				continue;
 			}
 		}
 		break;
 	}
-	return (reader_.source() != 0);
+	return reader_.active();
 }
 
 /*	Read next line of source to an appropriate	LineBuffer
@@ -259,7 +270,13 @@ void Scanner::readLineToBuffer()
 	// read line of source to this buffer, 
 	// apply preprocessor.
 
-	*reader_.source() >> lb->raw_;
+	if (reader_.inMemory())
+		reader_.readLine(lb->text_, lb->length_);
+	else {
+		*reader_.source() >> lb->raw_;
+		lb->text_ = lb->raw_.chars();
+		lb->length_ = lb->raw_.length();
+	}
 //	reader_->readLine(lb->raw_);
 #if DEBUG && 0
 	WARN("Reading all lines at once");
@@ -278,7 +295,7 @@ void Scanner::filterAndEcho() {
 #endif
 
 	if (echo()) 
-		printSourceLine(lb->raw_, reader_.lineNumber());
+		printSourceLine(lb->text_, lb->length_, reader_.lineNumber());
 #if _WITHPP	
 	if (echoFiltered()) 
 		printSourceLine(lb->filtered_, echo() ? -1 : reader_.lineNumber());
@@ -327,7 +344,7 @@ void Scanner::getTokenText(String &dest)
 {
 	int pos, len;
 	tokenizer_->getLastItem(pos, len);
-	tokenizer_->str().subStr(pos, len, dest);
+	dest.set(tokenizer_->chars(), pos, len);
 }
 
 void Scanner::read_(Token &token)
@@ -352,13 +369,11 @@ void Scanner::read_(Token &token)
 			crSent_ = false;
 			filterAndEcho();
 			LineBuffer *lb = lineBuffers_.itemAt(currentLineBuffer_);
-			tokenizer_->begin(
 #if _WITHPP
-				lb->filtered_
+			tokenizer_->begin(lb->filtered_);
 #else
-				lb->raw_
+			tokenizer_->begin(lb->text_, lb->length_);
 #endif
-			);
 		}
 
 		// if end of line, we must increment line and repeat.
@@ -402,7 +417,8 @@ void Scanner::read_(Token &token)
 
 		token.setStr(tokenizer_->str().subStr(tokenPos,tokenLen));
 #else
-		// this saves 26% of the time
+		// this saves 26% of the time.  Text in memory outlives the
+		// tokens, so they can refer to it rather than copying it
 		token.set(
 			tokenType,lineNumber_,
 #if _WITHPP
@@ -410,7 +426,12 @@ void Scanner::read_(Token &token)
 #else
 			tokenPos,
 #endif
-			&tokenizer_->str(), tokenPos, tokenLen
+			tokenizer_->chars() + tokenPos, tokenLen,
+#if _WITHPP
+			true
+#else
+			!reader_.inMemory()
+#endif
 			);
 #endif
 //pr(("--[%s]\n",token.str().s() ));
@@ -420,7 +441,7 @@ void Scanner::read_(Token &token)
 	//pr((" Scanner read %s\n",token.str().chars() ));
 }
 
-void Scanner::printSourceLine(const String &s, int lineNumber,
+void Scanner::printSourceLine(const char *s, int len, int lineNumber,
 															Sink *outPtr) const
 {
 	if (outPtr == 0) {
@@ -438,8 +459,8 @@ void Scanner::printSourceLine(const String &s, int lineNumber,
 		OUT << "[";
 #endif
 		// change tabs to spaces
-		for (int i = 0; i < s.length(); i++) {
-			char c = s.charAt(i);
+		for (int i = 0; i < len; i++) {
+			char c = s[i];
 			if (c < ' ') {
 				if (c == '\t')
 					c = ' ';
@@ -449,8 +470,8 @@ void Scanner::printSourceLine(const String &s, int lineNumber,
 #if DEBUG && 0
 		OUT << "]";
 #endif
-		if (s.length() == 0
-			|| s.charAt(s.length()-1) != '\n')
+		if (len == 0
+			|| s[len-1] != '\n')
 			OUT << "\n";
 }
 
@@ -529,7 +550,7 @@ void Scanner::flushErrors() {
 				printSourceLine(marks,-1,&OUT);
 			}
 			if (!printedErrPath_) {
-				if (reader_.source() != 0) {
+				if (reader_.active()) {
 				//ASSERT(reader_.source() != 0);
 					if (reader_.name().length() > 0) {
 						OUT << "File " << reader_.name() << ", ";
@@ -574,8 +595,10 @@ void Scanner::addError(const String &msg) {
 
 	String raw;
 
-	if (len > 0) 
-		raw.set(lineBuffers_.itemAt(currentLineBuffer_)->raw_);
+	if (len > 0) {
+		LineBuffer *lb = lineBuffers_.itemAt(currentLineBuffer_);
+		raw.set(lb->text_, 0, lb->length_);
+	}
 	
 	rec->set(msg2,
 		lineNumber_,
@@ -600,7 +623,7 @@ void Scanner::includeSource(Source &src, const String *name)
 	pt(("Scanner::include\n",name ? name->chars() : "<unknown>"));
 
 	// If current reader exists, push on stack.
-	if (reader_.source()) {
+	if (reader_.active()) {
 		readers_.push(reader_);
 		reader_ = SourceRec();
 	}
@@ -614,6 +637,21 @@ void Scanner::includeSource(Source &src, const String *name)
 	printedErrPath_ = false;
 }
 
+void Scanner::includeText(const char *text, int len, const String *name)
+{
+	// If current reader exists, push on stack.
+	if (reader_.active()) {
+		readers_.push(reader_);
+		reader_ = SourceRec();
+	}
+	reader_.start(text, len, name);
+	lineNumber_ = reader_.lineNumber();
+
+	if (echo())
+		Cout << "Reading: " << reader_.name() << "\n";
+	printedErrPath_ = false;
+}
+
 Source& Scanner::operator >> (String &s)
 {
 	Token t;
@@ -699,8 +737,42 @@ void Scanner::SourceRec::start(Source &src, const String *name) {
 	lineNumber_ = 0;
 }
 
+void Scanner::SourceRec::start(const char *text, int len,
+	const String *name) {
+	source_ = 0;
+	name_.set(name ? name->chars() : "<unknown>");
+	lineNumber_ = 0;
+	text_ = text;
+	length_ = len;
+	pos_ = 0;
+}
+
+void Scanner::SourceRec::readLine(const char *&line, int &len) {
+	ASSERT(text_ != 0 && pos_ <= length_);
+	// like TextReader, treat text that is empty or ends with \n
+	// as having a final empty line
+	if (pos_ == length_) {
+		line = "\n";
+		len = 1;
+		pos_++;
+		return;
+	}
+	line = text_ + pos_;
+	const char *nl = (const char *)memchr(line, '\n', length_ - pos_);
+	if (nl != 0) {
+		len = (int)(nl - line) + 1;
+		pos_ += len;
+	} else {
+		len = length_ - pos_;
+		pos_ = length_ + 1;
+	}
+}
+
 void Scanner::SourceRec::close() {
 	source_ = 0;
+	text_ = 0;
+	length_ = 0;
+	pos_ = 0;
 }
 
 #if DEBUG
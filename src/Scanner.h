@@ -34,7 +34,9 @@ public:
 	void getCursor(int &line, int &col) const {
 		line = prevLine_+1; col = prevCol_+1; }
 
-	/*	Add a text file to the queue to be read from
+	/*	Add a text file to the queue to be read from.  Queued files are
+			mapped into memory, and tokens read from them refer to their
+			text rather than copying it.
 			> path					filename
 	*/
 	void queueTextFile(String &path);
@@ -176,26 +178,74 @@ private:
 
 	/*	Print a line of source, optionally preceded by line numbers
 			> s								source line
+			> len							length of line
 			> lineNumber			line number within file (0 = first line)
 	*/
-	void printSourceLine(const String &s, int lineNumber,
+	void printSourceLine(const char *s, int len, int lineNumber,
 		Sink *outPtr = 0) const;
+	void printSourceLine(const String &s, int lineNumber,
+		Sink *outPtr = 0) const {
+		printSourceLine(s.chars(), s.length(), lineNumber, outPtr);
+	}
+
+	/*	Include text in memory to read from
+			> text						characters to read; must remain unchanged
+												 for the life of the scanner
+			> len							number of characters
+			> name						filename to display (for errors)
+	*/
+	void includeText(const char *text, int len, const String *name);
+
+	/*	Fill the lookahead buffer with the next token that isn't skipped
+	*/
+	void fillLookahead();
 
+	/*	A source being read: either a Source, or text in memory
+	*/
 	class SourceRec {
 	public:
 		SourceRec() {
 			source_ = 0;
+			text_ = 0;
+			length_ = 0;
+			pos_ = 0;
 			lineNumber_ = 0;
 		}
 		Source *source() const {return source_;}
 		int lineNumber() const {return lineNumber_;}
 		const String &name() const {return name_;}
 		void start(Source &src, const String *name);
+		void start(const char *text, int len, const String *name);
 		void incLineNumber() {lineNumber_++;}
 		void close();
+
+		/*	Determine if a source is being read
+		*/
+		bool active() const {return source_ != 0 || text_ != 0;}
+
+		/*	Determine if the source is text in memory
+		*/
+		bool inMemory() const {return text_ != 0;}
+
+		/*	Determine if the end of the source has been reached
+		*/
+		bool atEnd() const {
+			return text_ != 0 ? pos_ > length_ : source_->eof();
+		}
+
+		/*	Read the next line of text in memory, including its \n
+				> line						pointer to its first character stored here
+				> len							its length stored here
+		*/
+		void readLine(const char *&line, int &len);
 	private:
 		String name_;
 		Source *source_;
+		// text in memory, its length, and position of next line
+		// (length + 1 once the final line has been read)
+		const char *text_;
+		int length_;
+		int pos_;
 		int lineNumber_;
 	};
 
@@ -250,7 +300,11 @@ private:
 	public:
 		// compile session line number this buffer currently contains
 		int lineNumber_;
-		// raw source string 
+		// characters of the line, and their number; these are either
+		// in raw_, or in text being read from memory
+		const char *text_;
+		int length_;
+		// raw source string, if not reading from memory
 		String raw_;
 #if _WITHPP
 		// filtered (preprocessed) string
@@ -266,8 +320,9 @@ private:
 	int fileNumber_;
 	// array of queued text files
 	StringArray fileQueue_;
-	// reader for queued files
-	TextReader qReader_;
+	// queued files that have been opened; they are kept until the
+	// scanner is destroyed, since tokens may refer to their text
+	Array<MappedFile *> mappedFiles_;
 };
 
 #if DEBUG
@@ -0,0 +1,387 @@
+#include "globals.h"
+
+#if UNIX
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+#undef p2
+#define p2(a) //pr(a)
+
+enum {
+	// maximum length of request header line
+	MAX_HEADER = 256,
+	// maximum number of outputs cached for each model
+	MAX_CACHE = 256,
+	// size of buffer for reading from sockets
+	READ_SIZE = 4096
+};
+
+Server::Server(DFA &dfa, Context &context, int options)
+: dfa_(dfa), context_(context)
+{
+	// a request's formulas are forgotten once it's processed, so
+	// keeping them for any changes it makes to the model is cheap
+	options_ = options | Session::OPT_SHAREDVARS | Session::OPT_RECHECK;
+	workers_ = 1;
+	listenFd_ = -1;
+}
+
+Server::~Server()
+{
+	for (int i = 0; i < clients_.length(); i++) {
+#if UNIX
+		if (clients_[i]->fd >= 0)
+			close(clients_[i]->fd);
+#endif
+		delete clients_[i];
+	}
+	for (int i = 0; i < models_.length(); i++)
+		delete models_[i];
+#if UNIX
+	if (listenFd_ >= 0)
+		close(listenFd_);
+#endif
+}
+
+void Server::run(const String &path)
+{
+#if UNIX
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.length() >= (int)sizeof(addr.sun_path))
+		throw Exception("Socket path is too long");
+	strcpy(addr.sun_path, path.chars());
+
+	listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd_ < 0)
+		throw Exception("Unable to create socket");
+
+	unlink(path.chars());
+	if (bind(listenFd_, (struct sockaddr *)&addr, sizeof(addr)) < 0
+		|| listen(listenFd_, 64) < 0) {
+		String s("Unable to listen on socket ");
+		s << path;
+		throw Exception(s);
+	}
+	fcntl(listenFd_, F_SETFL, O_NONBLOCK);
+
+	Cout << "Listening on " << path << "\n";
+
+	while (true) {
+		// entry 0 is the listening socket, and entry i+1 is client i
+		// (poll() is used rather than select(), which can't handle
+		// descriptors >= FD_SETSIZE)
+		Array<struct pollfd> fds;
+		struct pollfd pfd;
+		pfd.fd = listenFd_;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		fds.add(pfd);
+		bool pending = false;
+
+		for (int i = 0; i < clients_.length(); i++) {
+			Client &c = *clients_[i];
+			pfd.fd = c.fd;
+			pfd.events = 0;
+			if (!c.closing)
+				pfd.events |= POLLIN;
+			if (c.out.length() > 0)
+				pfd.events |= POLLOUT;
+			fds.add(pfd);
+			if (c.commands.length() > 0)
+				pending = true;
+		}
+
+		// if requests are waiting, just check for more input
+		if (::poll(&fds[0], fds.length(), pending ? 0 : -1) < 0) {
+			if (errno == EINTR) continue;
+			throw Exception("Error waiting for clients");
+		}
+
+		// read from the clients that were polled, before accepting
+		// new ones (which are added to the end of the list)
+		for (int i = 0; i < fds.length() - 1; i++) {
+			Client &c = *clients_[i];
+			if (c.fd >= 0 && (fds[i+1].revents & (POLLIN | POLLHUP | POLLERR)))
+				readClient(c);
+		}
+
+		if (fds[0].revents & POLLIN)
+			accept();
+
+		handleRound();
+
+		// free the nodes of formulas that have been discarded
+		context_.forest().reclaim();
+
+		for (int i = 0; i < clients_.length(); i++) {
+			Client &c = *clients_[i];
+			if (c.fd >= 0 && c.out.length() > 0)
+				writeClient(c);
+			if (c.fd >= 0 && c.closing && c.commands.length() == 0
+				&& c.out.length() == 0) {
+				close(c.fd);
+				c.fd = -1;
+			}
+			if (c.fd < 0) {
+				p2(("removing client %d\n",i));
+				delete clients_[i];
+				clients_.remove(i--, 1);
+			}
+		}
+	}
+#else
+	throw Exception("Server mode is not supported on this platform");
+#endif
+}
+
+void Server::accept()
+{
+#if UNIX
+	while (true) {
+		int fd = ::accept(listenFd_, 0, 0);
+		if (fd < 0) break;
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		Client *c = new Client();
+		c->fd = fd;
+		clients_.add(c);
+		p2(("accepted client, fd=%d\n",fd));
+	}
+#endif
+}
+
+void Server::readClient(Client &c)
+{
+#if UNIX
+	char buffer[READ_SIZE];
+	while (true) {
+		int n = recv(c.fd, buffer, READ_SIZE, 0);
+		if (n > 0) {
+			c.in.append(buffer, 0, n);
+			continue;
+		}
+		if (n == 0) {
+			// client has finished sending; close once the requests
+			// it sent have been answered
+			c.closing = true;
+		} else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			close(c.fd);
+			c.fd = -1;
+			return;
+		}
+		break;
+	}
+
+	// extract complete requests
+
+	while (c.in.length() > 0) {
+		int eol = c.in.indexOf('\n');
+		if (eol < 0) {
+			if (c.in.length() > MAX_HEADER) {
+				reply(c, false, "*** Request header is too long\n");
+				c.in.clear();
+				c.closing = true;
+			}
+			break;
+		}
+
+		StringArray words;
+		c.in.subStr(0, eol).split(words, ' ');
+
+		int len = -1;
+		if (words.length() == 3) {
+			try {
+				len = Utils::parseInt(words[2]);
+			} catch (Exception &e) {
+			}
+		}
+		if (len < 0) {
+			reply(c, false, "*** Badly formed request header\n");
+			c.in.clear();
+			c.closing = true;
+			break;
+		}
+
+		if (c.in.length() < eol + 1 + len)
+			break;
+
+		c.commands.add(words[0]);
+		c.models.add(words[1]);
+		c.payloads.add(c.in.subStr(eol + 1, len));
+		c.in.remove(0, eol + 1 + len);
+	}
+#endif
+}
+
+void Server::writeClient(Client &c)
+{
+#if UNIX
+	int n = send(c.fd, c.out.chars(), c.out.length(), MSG_NOSIGNAL);
+	if (n > 0) {
+		c.out.remove(0, n);
+	} else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK
+		&& errno != EINTR) {
+		close(c.fd);
+		c.fd = -1;
+	}
+#endif
+}
+
+void Server::handleRound()
+{
+	// clients with requests waiting
+	Array<Client *> ready;
+	for (int i = 0; i < clients_.length(); i++) {
+		Client *c = clients_[i];
+		if (c->fd >= 0 && c->commands.length() > 0)
+			ready.add(c);
+	}
+
+	// handle the oldest request from each client, one at a time
+	// (each request's formulas may be checked on several threads);
+	// they're ordered by model, so those for the same model are
+	// handled one after another
+
+	BitStore done;
+	for (int i = 0; i < ready.length(); i++) {
+		if (done.get(i)) continue;
+		String model(ready[i]->models[0]);
+
+		for (int j = i; j < ready.length(); j++) {
+			Client &c = *ready[j];
+			if (done.get(j) || !c.models[0].equals(model)) continue;
+			done.set(j);
+
+			p2(("handling %s %s\n",c.commands[0].chars(),model.chars()));
+			String output;
+			bool success = handle(c.commands[0], model, c.payloads[0], output);
+			reply(c, success, output);
+
+			c.commands.remove(0, 1);
+			c.models.remove(0, 1);
+			c.payloads.remove(0, 1);
+		}
+	}
+}
+
+bool Server::handle(const String &command, const String &model,
+	const String &payload, String &output)
+{
+	int m = findModel(model);
+
+	if (command.equals("load")) {
+		if (m < 0) {
+			m = models_.length();
+			models_.add(new Resident(context_.vars(), options_, workers_));
+			modelNames_.add(model);
+		}
+		Resident &r = *models_[m];
+		bool success = process(r.session, payload, output);
+		if (success) {
+			Utils::pushSink(&output);
+			r.session.finish();
+			Utils::popSink();
+		}
+		if (!success || !r.session.model().defined()) {
+			if (success)
+				output << "*** No model defined\n";
+			delete models_[m];
+			models_.remove(m, 1);
+			modelNames_.remove(m, 1);
+			return false;
+		}
+		return true;
+	}
+
+	if (command.equals("check")) {
+		if (m < 0) {
+			output << "*** No such model: " << model << "\n";
+			return false;
+		}
+		Resident &r = *models_[m];
+		if (r.cacheGeneration != r.session.generation()) {
+			r.cacheIn.clear();
+			r.cacheOut.clear();
+			r.cacheGeneration = r.session.generation();
+		}
+		for (int i = 0; i < r.cacheIn.length(); i++) {
+			if (r.cacheIn[i].equals(payload)) {
+				output << r.cacheOut[i];
+				return true;
+			}
+		}
+
+		bool success = process(r.session, payload, output);
+		if (success && r.session.generation() == r.cacheGeneration) {
+			if (r.cacheIn.length() == MAX_CACHE) {
+				r.cacheIn.clear();
+				r.cacheOut.clear();
+			}
+			r.cacheIn.add(payload);
+			r.cacheOut.add(output);
+		}
+		return success;
+	}
+
+	if (command.equals("compare")) {
+		Session s(context_.vars(), options_);
+		s.setWorkers(workers_);
+		return process(s, payload, output);
+	}
+
+	if (command.equals("drop")) {
+		if (m < 0) {
+			output << "*** No such model: " << model << "\n";
+			return false;
+		}
+		delete models_[m];
+		models_.remove(m, 1);
+		modelNames_.remove(m, 1);
+		return true;
+	}
+
+	output << "*** Unknown command: " << command << "\n";
+	return false;
+}
+
+bool Server::process(Session &s, const String &text, String &output)
+{
+	// formulas from earlier requests shouldn't be rechecked if
+	// this one changes the model
+	s.forgetFormulas();
+
+	Scanner scan(0,&dfa_);
+	scan.setSkip(TK_WS);
+	StringReader rd(text);
+	String name("request");
+	scan.includeSource(rd, &name);
+
+	Utils::pushSink(&output);
+	Utils::useErrorSink(&output);
+	bool success = s.process(scan);
+	Utils::useErrorSink(0);
+	Utils::popSink();
+	return success;
+}
+
+int Server::findModel(const String &name) const
+{
+	for (int i = 0; i < modelNames_.length(); i++)
+		if (modelNames_[i].equals(name))
+			return i;
+	return -1;
+}
+
+void Server::reply(Client &c, bool success, const String &output)
+{
+	c.out << (success ? "ok " : "error ") << output.length() << "\n";
+	c.out << output;
+}
@@ -0,0 +1,177 @@
+#ifndef _SERVER
+#define _SERVER
+
+/*	Checking server.  Listens on a Unix domain socket, and keeps
+		models resident between requests, so clients can check
+		formulas without starting a new process and reparsing the
+		model each time.
+
+		A client sends any number of requests over a connection.
+		Each request is a header line followed by a payload:
+
+			<command> <model> <length>\n
+			<length bytes of payload>
+
+		where <model> is a name chosen by the client, and <command>
+		is one of:
+
+			load							parse the payload (a model, in the usual
+												syntax, optionally followed by formulas),
+												and keep it resident as <model>
+			check							check the formulas in the payload against
+												resident model <model>; the payload may
+												also contain model changes ('+{ ... }'),
+												which persist
+			compare						compare the LTL formulas in the payload
+												('? <form> : <form>'); <model> is ignored
+			drop							discard resident model <model>
+
+		For each request, the server replies with
+
+			<status> <length>\n
+			<length bytes of output>
+
+		where <status> is 'ok' or 'error'; the output is what the
+		command line checker would print for the same input.
+
+		Requests are handled one at a time, on the server's thread,
+		in rounds.  In each round, the server takes the oldest
+		pending request from each client, so a client with many
+		requests queued doesn't delay the others; but a request that
+		takes a long time to check delays every client.  The formulas
+		within a request are checked on the number of threads set by
+		setWorkers() (see Session::setWorkers()).  The output of each
+		check request is kept (until the model is changed), and a
+		later check request with an identical payload is answered
+		from it, rather than being evaluated again; nothing else,
+		such as the automata built for LTL formulas, is kept between
+		requests.
+
+		Only supported on Unix.
+*/
+class Server {
+public:
+	/*	Constructor
+			> dfa							DFA for recognizing tokens
+			> context					context containing formulas; its symbol
+												table is shared by all models
+			> options					options for sessions (Session::OPT_xxx)
+	*/
+	Server(DFA &dfa, Context &context, int options = 0);
+	~Server();
+
+	/*	Listen for and serve clients; doesn't return unless an
+			error occurs
+			> path						path of socket
+	*/
+	void run(const String &path);
+
+	/*	Set number of threads to check each request's formulas with
+			> n								number of threads
+	*/
+	void setWorkers(int n) {workers_ = n;}
+
+private:
+	// no copying allowed
+	Server(const Server &s);
+	Server& operator=(const Server &s);
+
+	class Client {
+	public:
+		Client() {
+			fd = -1;
+			closing = false;
+		}
+		// socket, or -1 if closed
+		int fd;
+		// input not yet parsed into requests
+		String in;
+		// output not yet written
+		String out;
+		// true to close once output has been written
+		bool closing;
+		// requests read but not yet handled
+		StringArray commands;
+		StringArray models;
+		StringArray payloads;
+	};
+
+	class Resident {
+	public:
+		Resident(Vars &vars, int options, int workers)
+		: session(vars, options) {
+			session.setWorkers(workers);
+			cacheGeneration = -1;
+		}
+		Session session;
+		// payloads of check requests handled since the model was
+		// last changed, and their output
+		StringArray cacheIn;
+		StringArray cacheOut;
+		int cacheGeneration;
+	};
+
+	/*	Accept a new client connection
+	*/
+	void accept();
+
+	/*	Read available input from a client, and extract complete
+			requests from it
+			> c								client
+	*/
+	void readClient(Client &c);
+
+	/*	Write pending output to a client
+			> c								client
+	*/
+	void writeClient(Client &c);
+
+	/*	Handle one round of requests
+	*/
+	void handleRound();
+
+	/*	Handle a request
+			> command					command
+			> model						name of model
+			> payload					payload
+			> output					output is stored here
+			< true if successful
+	*/
+	bool handle(const String &command, const String &model,
+		const String &payload, String &output);
+
+	/*	Process text with a session
+			> s								session
+			> text						text to process
+			> output					output is appended to this
+			< true if no error occurred
+	*/
+	bool process(Session &s, const String &text, String &output);
+
+	/*	Find resident model
+			> name						name of model
+			< index of model, or -1 if not found
+	*/
+	int findModel(const String &name) const;
+
+	/*	Send reply to a client
+	*/
+	static void reply(Client &c, bool success, const String &output);
+
+	DFA &dfa_;
+	Context &context_;
+	int options_;
+	// number of threads to check each request's formulas with
+	int workers_;
+
+	// listening socket
+	int listenFd_;
+
+	Array<Client *> clients_;
+
+	// resident models, and their names
+	Array<Resident *> models_;
+	StringArray modelNames_;
+};
+
+#endif // _SERVER
@@ -0,0 +1,528 @@
+#include "globals.h"
+
+#define SKIP_EXCEPT (DEBUG && 0)
+
+/*	Convert session options to LTL checker options
+*/
+static int ltlOptions(int options)
+{
+	int r = 0;
+	if (options & Session::OPT_VERBOSE)
+		r |= LTLCheck::OPT_PRINTSTATES | LTLCheck::OPT_PRINTFULLSEQ;
+	if (options & Session::OPT_PRINTBUCHI)
+		r |= LTLCheck::OPT_PRINTBUCHI;
+	if (options & Session::OPT_CONCURRENT)
+		r |= LTLCheck::OPT_CONCURRENT;
+	if (options & Session::OPT_BRIEF)
+		r |= LTLCheck::OPT_BRIEF;
+	return r;
+}
+
+/*	Describe result of checking a formula, for statistics
+*/
+static const char *verdict(bool satisfied)
+{
+	return satisfied ? "satisfied" : "not satisfied";
+}
+
+/*	A formula queued to be checked by a worker thread.  What the
+		check prints, and its statistics, are stored here until the
+		batch is complete.
+*/
+class Session::Job {
+public:
+	Job() {
+		ctl = 0;
+		ltl = 0;
+		ok = false;
+		failed = false;
+	}
+	~Job() {
+		delete ctl;
+		delete ltl;
+	}
+
+	// CTL checker, if CTL formula
+	CTLCheck *ctl;
+	// LTL checker, if LTL formula
+	LTLCheck *ltl;
+	// formula, to be rechecked if the model is changed
+	Formula f;
+	// formula, as printed
+	String text;
+	// output of check
+	String output;
+	Stats stats;
+	// true if formula is satisfied
+	bool ok;
+	// true if check threw an exception, and its message
+	bool failed;
+	String error;
+};
+
+/*	Thread that runs queued checks
+*/
+class Session::Worker : public Thread {
+public:
+	Worker(Session &s) : session_(s), context_(Context::current()) {}
+protected:
+	virtual void run() {
+		// the formulas belong to the context of the thread that
+		// queued them
+		Context::Use use(context_);
+		session_.runJobs();
+	}
+private:
+	Session &session_;
+	Context &context_;
+};
+
+/*	Get the index of the next job to start, and advance it; the
+		index is shared by the worker threads
+*/
+static int nextIndex(volatile int &v)
+{
+#if UNIX
+	return __sync_fetch_and_add(&v, 1);
+#else
+	return v++;
+#endif
+}
+
+Session::Session(Vars &vars, int options)
+: vars_(vars), model_(vars), ltl_(vars, ltlOptions(options))
+{
+	options_ = options;
+	generation_ = 0;
+	formulasDefined_ = false;
+	workers_ = 1;
+	nextJob_ = 0;
+}
+
+void Session::forgetFormulas()
+{
+	ctlText_.clear();
+	ctlChecks_.clear();
+	ltlText_.clear();
+	ltlForms_.clear();
+}
+
+bool Session::process(Scanner &scan)
+{
+	bool success = true;
+#if SKIP_EXCEPT
+	WARN("Not catching exceptions");
+#else
+	try
+#endif
+	{
+		while (!scan.eof()) {
+			processItem(scan);
+			// free the nodes of formulas discarded by this item
+			Formula::forest().reclaim();
+		}
+		runBatch();
+		Formula::forest().reclaim();
+	}
+#if SKIP_EXCEPT
+	try {
+	}
+#endif
+	// exceeding the memory budget, and errors found by checks run
+	// after more input was read, aren't due to the text at the
+	// scanner's position
+	catch (MemoryException &e) {
+		fail(scan, e.str(), false);
+		success = false;
+	}
+	catch (CheckException &e) {
+		fail(scan, e.str(), false);
+		success = false;
+	}
+	catch (Exception &e) {
+		fail(scan, e.str(), true);
+		success = false;
+	}
+	return success;
+}
+
+void Session::fail(Scanner &scan, const String &msg, bool located)
+{
+	// the formulas read before the error are still checked; if
+	// one of them fails, that's the error reported
+	String err(msg);
+	try {
+		runBatch();
+	} catch (Exception &e) {
+		err = e.str();
+		located = false;
+	}
+	if (located)
+		scan.addError(err);
+	scan.flushErrors();
+	if (!located)
+		Utils::getErrorSink() << "*** Error: " << err << "\n";
+	Formula::forest().reclaim();
+}
+
+void Session::finish()
+{
+	if (!formulasDefined_ && model_.defined()) {
+		model_.print();
+		Cout << "\n";
+	}
+}
+
+void Session::processItem(Scanner &scan)
+{
+	bool verbose = option(OPT_VERBOSE);
+
+	Token t;
+	scan.peek(t);
+
+	// the formulas queued so far are checked against the model
+	// before anything else is done with it
+	if (t.type(TK_MODELOP) || t.type(TK_DELTAOP) || t.type(TK_COMPARE))
+		runBatch();
+
+	// each item is a separate check, as far as the memory budget
+	// is concerned
+	MemAccount::Check check;
+
+	//	is it a model definition?
+	if (t.type(TK_MODELOP)) {
+		model_.clear();
+		if (!option(OPT_SHAREDVARS))
+			vars_.clear();
+		forgetFormulas();
+		formulasDefined_ = false;
+		generation_++;
+		{
+			Stats::Timer timer(Stats::PH_PARSE);
+			MemAccount acc(MemAccount::MODEL);
+			model_.parse(scan);
+		}
+		if (Stats::enabled()) {
+			int trans = 0;
+			for (int i = 0; i < model_.states(); i++)
+				trans += model_.degree(model_.stateName(i));
+			Stats::current().count(Stats::MODEL_STATES, model_.states());
+			Stats::current().count(Stats::MODEL_TRANS, trans);
+			Stats::report("model", "", "parsed");
+		}
+
+		Cout << "Parsed model, " << model_.states() << " states\n\n";
+		if (verbose) {
+			model_.print();
+			Cout << "\n";
+			formulasDefined_ = true;
+		}
+		return;
+	}
+
+	if (t.type(TK_DELTAOP)) {
+
+		// +{ <changes> }
+		// change the model, and recheck the formulas kept for it
+
+		if (!model_.defined())
+			throw ParseException("No model to change");
+
+		OrdSet changed;
+		generation_++;
+		{
+			Stats::Timer timer(Stats::PH_PARSE);
+			MemAccount acc(MemAccount::MODEL);
+			model_.parseDelta(scan, changed);
+		}
+		Stats::current().count(Stats::MODEL_STATES, changed.length());
+		Stats::report("delta", "", "applied");
+
+		Cout << "Changed model, " << changed.length() << " states affected\n\n";
+		if (verbose) {
+			model_.print();
+			Cout << "\n";
+		}
+
+		for (int i = 0; i < ctlChecks_.length(); i++) {
+			Cout << ctlText_[i] << "\n";
+			BitStore sat;
+			ctlChecks_[i].update(changed, &sat);
+			bool ok = reportCTL(sat);
+			Stats::report("ctl", ctlText_[i], verdict(ok));
+		}
+		for (int i = 0; i < ltlForms_.length(); i++) {
+			Cout << ltlText_[i] << "\n";
+			bool ok = ltl_.check(model_, ltlForms_[i]);
+			Stats::report("ltl", ltlText_[i], verdict(ok));
+		}
+		return;
+	}
+
+	if (t.type(TK_COMPARE)) {
+
+		// ? <form> : <form>
+		// compare two LTL formulas
+
+		formulasDefined_ = model_.defined();
+		scan.read();
+
+		Formula f1, f2;
+		{
+			Stats::Timer timer(Stats::PH_PARSE);
+			MemAccount acc(MemAccount::FORMULA);
+			f1.parse(scan);
+			scan.read(TK_COMPAREMID);
+			f2.parse(scan);
+		}
+
+		bool equiv = ltl_.compare(f1,f2,option(OPT_PRINTREDUCED));
+
+		if (Stats::enabled()) {
+			String text;
+			Utils::pushSink(&text);
+			f1.print(-1,false);
+			Cout << " : ";
+			f2.print(-1,false);
+			Utils::popSink();
+			Stats::report("compare", text,
+				equiv ? "equivalent" : "not equivalent");
+		}
+		return;
+	}
+
+	// assume it's a formula.
+
+	formulasDefined_ = model_.defined();
+
+	Formula f;
+	{
+		Stats::Timer timer(Stats::PH_PARSE);
+		MemAccount acc(MemAccount::FORMULA);
+		f.parse(scan);
+	}
+
+	String text;
+	Utils::pushSink(&text);
+	f.print();
+	Utils::popSink();
+
+	bool ctl = f.isCTL()
+#if FAVOR_LTL
+			// treat as LTL if both for debug purposes
+		&& !f.isLTL()
+#endif
+		;
+
+	if (model_.defined() && batch() && (ctl || f.isLTL())) {
+		queue(f, text, ctl);
+		return;
+	}
+	runBatch();
+
+	Cout << text;
+	if (option(OPT_PRINTREDUCED)) {
+		Utils::pad(6);
+		f.printReduced();
+	}
+	Cout << "\n";
+
+	if (!model_.defined()) {
+		Stats::report("formula", text, "not checked");
+		return;
+	}
+
+	// if a model has been defined,
+	// check it against this formula.
+
+	if (ctl) {
+		CTLCheck c;
+		BitStore sat;
+		if (option(OPT_LOCAL) && !verbose && !option(OPT_SHOWMARKED))
+			c.checkLocal(vars_, model_, f, &sat);
+		else
+			c.check(vars_,model_, f, &sat, verbose, option(OPT_SHOWMARKED));
+		bool ok = reportCTL(sat);
+		Stats::report("ctl", text, verdict(ok));
+
+		if (option(OPT_RECHECK)) {
+			ctlText_.add(text);
+			ctlChecks_.add(c);
+		}
+		return;
+	}
+
+	if (f.isLTL()) {
+		if (option(OPT_RECHECK)) {
+			ltlText_.add(text);
+			ltlForms_.add(f);
+		}
+		bool ok = ltl_.check(model_, f);
+		Stats::report("ltl", text, verdict(ok));
+		return;
+	}
+
+	Cout << "(cannot check mixed CTL/LTL formula...)\n\n";
+	Stats::report("formula", text, "not checked");
+}
+
+bool Session::batch() const
+{
+	return workers_ > 1
+		&& !option(OPT_VERBOSE | OPT_SHOWMARKED | OPT_PRINTBUCHI);
+}
+
+void Session::queue(Formula &f, const String &text, bool ctl)
+{
+	Job *job = new Job();
+	job->text = text;
+
+	// the parsing statistics are reported with the check's
+	job->stats.add(Stats::current());
+	Stats::current().clear();
+
+	try {
+		Stats::Use use(job->stats);
+
+		Utils::pushSink(&job->output);
+		Cout << text;
+		if (option(OPT_PRINTREDUCED)) {
+			Utils::pad(6);
+			f.printReduced();
+		}
+		Cout << "\n";
+		Utils::popSink();
+
+		if (ctl) {
+			job->ctl = new CTLCheck();
+			job->ctl->begin(vars_, model_, f, option(OPT_LOCAL));
+		} else {
+			job->ltl = new LTLCheck(vars_, ltlOptions(options_));
+			ltl_.begin(f);
+			job->ltl->adopt(ltl_);
+			if (option(OPT_RECHECK))
+				job->f = f;
+		}
+	} catch (Exception &e) {
+		// report it once the formulas before it have been checked
+		job->failed = true;
+		job->error = e.str();
+		jobs_.add(job);
+		throw;
+	}
+	jobs_.add(job);
+}
+
+void Session::runBatch()
+{
+	if (jobs_.isEmpty())
+		return;
+
+	nextJob_ = 0;
+	Array<Worker *> workers;
+	for (int i = 0; i < workers_ && i < jobs_.length(); i++) {
+		Worker *w = new Worker(*this);
+		workers.add(w);
+		w->start(WORKER_STACK_SIZE);
+	}
+	for (int i = 0; i < workers.length(); i++) {
+		workers[i]->join();
+		delete workers[i];
+	}
+
+	// print the results in the order the formulas were read, up to
+	// the first check that failed (the formulas from it on aren't
+	// kept, as if checking had stopped there)
+	Job *failed = 0;
+	for (int i = 0; i < jobs_.length(); i++) {
+		Job &j = *jobs_[i];
+		Cout << j.output;
+		if (j.failed) {
+			failed = &j;
+			break;
+		}
+		Stats::current().add(j.stats);
+		Stats::report(j.ctl != 0 ? "ctl" : "ltl", j.text, verdict(j.ok));
+
+		if (option(OPT_RECHECK)) {
+			if (j.ctl != 0) {
+				ctlText_.add(j.text);
+				ctlChecks_.add(*j.ctl);
+			} else {
+				ltlText_.add(j.text);
+				ltlForms_.add(j.f);
+			}
+		}
+	}
+
+	String error;
+	if (failed != 0)
+		error = failed->error;
+
+	for (int i = 0; i < jobs_.length(); i++)
+		delete jobs_[i];
+	jobs_.clear();
+
+	if (failed != 0)
+		throw CheckException(error);
+}
+
+void Session::runJobs()
+{
+	while (true) {
+		int i = nextIndex(nextJob_);
+		if (i >= jobs_.length())
+			break;
+		Job &j = *jobs_[i];
+		if (j.failed)
+			continue;
+
+		Stats::Use use(j.stats);
+		Utils::pushSink(&j.output);
+		{
+			// each formula is a separate check, as far as the memory
+			// budget is concerned
+			MemAccount::Check check;
+			try {
+				if (j.ctl != 0) {
+					BitStore sat;
+					j.ctl->finish(&sat);
+					j.ok = reportCTL(sat);
+				} else
+					j.ok = j.ltl->finish(model_);
+			} catch (Exception &e) {
+				j.failed = true;
+				j.error = e.str();
+			}
+			j.stats.setPeaks(check);
+		}
+		Utils::popSink();
+	}
+}
+
+bool Session::reportCTL(BitStore &sat)
+{
+	String s;
+
+	// Verify that all start states satisfy the formula
+	const OrdSet &is = model_.initialStates();
+	bool first = true;
+	for (int i = 0; i < is.length(); i++) {
+		int iName = is[i];
+		if (!sat.get(model_.stateId(iName))) {
+			if (first) {
+				s << "Not satisfied; start states: ";
+				first = false;
+			} else
+				s << ' ';
+			s << iName;
+		}
+	}
+	if (first)
+		s << "Satisfied.";
+	s << "\n";
+
+	s << "\n";
+	Cout << s;
+	return first;
+}
@@ -0,0 +1,169 @@
+#ifndef _SESSION
+#define _SESSION
+
+/*	Checking session.  Reads models, model changes, formulas and
+		comparisons from a scanner, and checks each formula against
+		the current model.  The model (and, with OPT_RECHECK, the
+		formulas checked against it) are retained between calls to
+		process(), so a session can be fed input in pieces (see
+		Server).
+*/
+class Session {
+public:
+	/*	Constructor
+			> vars						symbol table
+			> options					OPT_xxx
+	*/
+	Session(Vars &vars, int options = 0);
+
+	enum {
+		OPT_VERBOSE = 0x0001,
+		// show CTL formulas as they're marked in states
+		OPT_SHOWMARKED = 0x0002,
+		OPT_PRINTREDUCED = 0x0004,
+		OPT_PRINTBUCHI = 0x0008,
+		// compare LTL formulas using two threads
+		OPT_CONCURRENT = 0x0010,
+		// print only whether LTL formulas are equivalent
+		OPT_BRIEF = 0x0020,
+		// don't clear the symbol table when a new model is read,
+		// since other sessions are using it
+		OPT_SHAREDVARS = 0x0040,
+		// check CTL formulas on demand, from the initial states only
+		// (unless the states satisfying each subformula are displayed)
+		OPT_LOCAL = 0x0080,
+		// keep the formulas checked against the model, so they can
+		// be rechecked if it's changed
+		OPT_RECHECK = 0x0100
+	};
+
+	/*	Process input until the scanner is exhausted.  Output is
+			written to the active sink; an error stops processing, and
+			is reported through the scanner.
+			> scan						scanner to read from
+			< true if no error occurred
+	*/
+	bool process(Scanner &scan);
+
+	/*	Print the model if no formulas have been checked against it
+	*/
+	void finish();
+
+	/*	Set number of threads to check formulas with.  If more than
+			one, the formulas read between models, model changes and
+			comparisons are parsed first, then checked concurrently, and
+			their results are printed in the order they were read.  The
+			checks are always made one at a time if their details are to
+			be displayed.
+			> n								number of threads
+	*/
+	void setWorkers(int n) {workers_ = n;}
+
+	/*	Forget the formulas that have been checked against the model,
+			so they aren't rechecked if the model is changed (they are
+			only kept if OPT_RECHECK is set)
+	*/
+	void forgetFormulas();
+
+	/*	Get the current model
+	*/
+	Model &model() {return model_;}
+
+	/*	Get number of times the model has been read or changed; can
+			be used to determine if results derived from it are stale
+	*/
+	int generation() const {return generation_;}
+
+private:
+	// no copying allowed
+	Session(const Session &s);
+	Session& operator=(const Session &s);
+
+	bool option(int flag) const {
+		return (options_ & flag) != 0;
+	}
+
+	/*	Process the next item from the scanner
+	*/
+	void processItem(Scanner &scan);
+
+	/*	Report an error that stopped processing, after checking the
+			formulas queued before it
+			> scan						scanner
+			> msg							message
+			> located					true to report it at the scanner's position
+	*/
+	void fail(Scanner &scan, const String &msg, bool located);
+
+	// a formula queued to be checked, and a thread that checks them
+	// (defined in Session.cpp)
+	class Job;
+	class Worker;
+
+	enum {
+		// stack size for worker threads; emptiness checking is
+		// recursive, so it's larger than usual
+		WORKER_STACK_SIZE = 1 << 26
+	};
+
+	/*	Determine if formulas are to be queued, to be checked
+			concurrently
+	*/
+	bool batch() const;
+
+	/*	Queue a formula to be checked.  Its text is printed to the
+			job's output, and the parts of the check that modify the
+			formula forest are done now; if they fail, the job is queued
+			as having failed, and the exception is rethrown.
+			> f								formula
+			> text						formula, as printed
+			> ctl							true to check it as a CTL formula,
+												false for LTL
+	*/
+	void queue(Formula &f, const String &text, bool ctl);
+
+	/*	Check the queued formulas, and print their results in the
+			order they were read.  If a check fails, the formulas read
+			after it are forgotten, and a CheckException with its
+			message is thrown.
+	*/
+	void runBatch();
+
+	/*	Run queued checks until there are none left; called by each
+			worker thread
+	*/
+	void runJobs();
+
+	/*	Print the result of a CTL check
+			> sat							flags of states satisfying the formula
+			< true if all initial states satisfy it
+	*/
+	bool reportCTL(BitStore &sat);
+
+	Vars &vars_;
+	Model model_;
+	LTLCheck ltl_;
+	int options_;
+	int generation_;
+
+	// true if formulas have been entered
+	bool formulasDefined_;
+
+	// formulas checked against the current model, as printed, and
+	// their checkers; these are rechecked if the model is changed,
+	// and are only kept if OPT_RECHECK is set, as each CTL checker
+	// holds a set of flags for every state
+	StringArray ctlText_;
+	Array<CTLCheck> ctlChecks_;
+	StringArray ltlText_;
+	Array<Formula> ltlForms_;
+
+	// number of threads to check formulas with
+	int workers_;
+	// formulas queued to be checked
+	Array<Job *> jobs_;
+	// index of next job to be started by a worker
+	volatile int nextJob_;
+};
+
+#endif // _SESSION
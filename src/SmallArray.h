@@ -0,0 +1,212 @@
+#ifndef _SMALLARRAY
+#define _SMALLARRAY
+
+/*	SmallArray: dynamic array of simple values, with room for N items
+		within the object itself.  A buffer is allocated from the heap
+		only if the array grows beyond that.
+
+		This suits the many small lists stored per state (such as
+		transitions), most of which hold only a few items.  Unlike Array,
+		it has no virtual destructor, so it adds no vtable pointer to
+		the objects containing it.
+*/
+template <typename T, int N>
+class SmallArray {
+public:
+	SmallArray() {construct();}
+	~SmallArray() {freeBuffer();}
+	SmallArray(const SmallArray &s) {
+		construct();
+		*this = s;
+	}
+	SmallArray& operator=(const SmallArray &s);
+#if HAS_MOVE
+	SmallArray(SmallArray &&s) {
+		construct();
+		take(s);
+	}
+	SmallArray& operator=(SmallArray &&s) {
+		swap(s);
+		return *this;
+	}
+#endif
+
+	/*	Exchange contents with another array
+	*/
+	void swap(SmallArray &s);
+
+	T &operator[](int i) const {return itemAt(i);}
+	T &itemAt(int i) const {
+		ASSERT(i >= 0 && i < length_);
+		return items_[i];
+	}
+	T &last() const {return itemAt(length_ - 1);}
+	int length() const {return length_;}
+	bool isEmpty() const {return length_ == 0;}
+	void clear() {length_ = 0;}
+
+	void add(const T &item) {
+		ensureCapacity(length_ + 1);
+		items_[length_++] = item;
+	}
+	T &pop() {
+		ASSERT(length_ > 0);
+		return items_[--length_];
+	}
+
+	/*	Insert an item
+			> offset					position to insert at
+			> item						item to insert
+	*/
+	void insert(int offset, const T &item);
+
+	/*	Remove items
+			> offset					position of first item to remove
+			> count						number to remove
+	*/
+	void remove(int offset, int count = 1);
+
+	void ensureCapacity(int n) {
+		if (n > capacity_)
+			grow(n);
+	}
+
+	/*	Determine if items are stored within the object, instead of
+			in a heap buffer
+	*/
+	bool isInline() const {return items_ == inline_;}
+
+private:
+	void construct() {
+		items_ = inline_;
+		length_ = 0;
+		capacity_ = N;
+		account_ = MemAccount::OTHER;
+	}
+
+	/*	Free the heap buffer, if there is one, and revert to inline storage
+	*/
+	void freeBuffer() {
+		if (!isInline()) {
+			MemAccount::release(account_, sizeof(T) * (long long)capacity_);
+			DeleteArray(items_);
+		}
+		construct();
+	}
+
+	/*	Take contents of another array, leaving it empty
+			> s								array; must be different from this one
+	*/
+	void take(SmallArray &s);
+
+	void grow(int n);
+
+	T *items_;
+	int length_;
+	int capacity_;
+	// account heap buffer is charged to (see MemAccount)
+	int account_;
+	T inline_[N];
+};
+
+template <typename T, int N>
+SmallArray<T,N>& SmallArray<T,N>::operator=(const SmallArray<T,N> &s)
+{
+	if (&s != this) {
+		length_ = 0;
+		ensureCapacity(s.length_);
+		for (int i = 0; i < s.length_; i++)
+			items_[i] = s.items_[i];
+		length_ = s.length_;
+	}
+	return *this;
+}
+
+template <typename T, int N>
+void SmallArray<T,N>::take(SmallArray<T,N> &s)
+{
+	ASSERT(&s != this);
+	freeBuffer();
+	if (s.isInline()) {
+		for (int i = 0; i < s.length_; i++)
+			items_[i] = s.items_[i];
+		length_ = s.length_;
+	} else {
+		items_ = s.items_;
+		length_ = s.length_;
+		capacity_ = s.capacity_;
+		account_ = s.account_;
+	}
+	s.construct();
+}
+
+template <typename T, int N>
+void SmallArray<T,N>::swap(SmallArray<T,N> &s)
+{
+	if (&s == this)
+		return;
+	if (!isInline() && !s.isInline()) {
+		swapVal(items_, s.items_);
+		swapVal(length_, s.length_);
+		swapVal(capacity_, s.capacity_);
+		swapVal(account_, s.account_);
+		return;
+	}
+	SmallArray<T,N> t;
+	t.take(*this);
+	take(s);
+	s.take(t);
+}
+
+template <typename T, int N>
+void SmallArray<T,N>::grow(int n)
+{
+	ASSERT(n < 1000000);
+	int newCapacity = maxVal(n, capacity_ * 2);
+
+	// charge the new buffer to the current account; this
+	// throws if the memory budget would be exceeded
+	int account = MemAccount::current();
+	MemAccount::charge(account, sizeof(T) * (long long)newCapacity);
+
+	T *nBuff;
+	NewArray(nBuff, newCapacity);
+	for (int i = 0; i < length_; i++)
+		nBuff[i] = items_[i];
+
+	int len = length_;
+	freeBuffer();
+	items_ = nBuff;
+	length_ = len;
+	capacity_ = newCapacity;
+	account_ = account;
+}
+
+template <typename T, int N>
+void SmallArray<T,N>::insert(int offset, const T &item)
+{
+	ASSERT(offset >= 0 && offset <= length_);
+	ensureCapacity(length_ + 1);
+	for (int i = length_; i > offset; i--)
+		items_[i] = items_[i - 1];
+	items_[offset] = item;
+	length_++;
+}
+
+template <typename T, int N>
+void SmallArray<T,N>::remove(int offset, int count)
+{
+	ASSERT(offset >= 0 && count >= 0 && offset + count <= length_);
+	for (int i = offset + count; i < length_; i++)
+		items_[i - count] = items_[i];
+	length_ -= count;
+}
+
+/*	Move an array, by exchanging its contents with the destination's
+*/
+template <typename T, int N>
+inline void moveValue(SmallArray<T,N> &dest, SmallArray<T,N> &src) {
+	dest.swap(src);
+}
+
+#endif // _SMALLARRAY
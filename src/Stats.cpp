@@ -0,0 +1,184 @@
+#include "globals.h"
+
+#if UNIX
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+
+THREAD_LOCAL long long memBytesAllocated;
+
+bool Stats::enabled_;
+THREAD_LOCAL Stats *Stats::current_;
+Stats Stats::default_;
+
+static const char *counterNames[] = {
+	"model_states",
+	"model_trans",
+	"tableau_nodes",
+	"formula_states",
+	"formula_trans",
+	"product_states",
+	"product_trans",
+	"reduced_states",
+	"reduced_trans",
+	"dfs_states",
+	"fixpoint_iters",
+	"reachable_states",
+	"bytes_allocated",
+};
+
+static const char *phaseNames[] = {
+	"parse",
+	"tableau",
+	"kripke",
+	"product",
+	"reduce",
+	"emptiness",
+	"ctl",
+};
+
+/*	Read wall clock
+		< time, in seconds
+*/
+static double now()
+{
+#if UNIX
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+#else
+	return clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+void Stats::clear()
+{
+	for (int i = 0; i < COUNTERS; i++)
+		counters_[i] = 0;
+	for (int i = 0; i < PHASES; i++)
+		times_[i] = 0;
+	peaksSet_ = false;
+}
+
+void Stats::add(const Stats &s)
+{
+	for (int i = 0; i < COUNTERS; i++)
+		counters_[i] += s.counters_[i];
+	for (int i = 0; i < PHASES; i++)
+		times_[i] += s.times_[i];
+	if (s.peaksSet_) {
+		for (int i = 0; i < MemAccount::TOTAL; i++)
+			if (!peaksSet_ || peaks_[i] < s.peaks_[i])
+				peaks_[i] = s.peaks_[i];
+		if (!peaksSet_ || peakTotal_ < s.peakTotal_)
+			peakTotal_ = s.peakTotal_;
+		peaksSet_ = true;
+	}
+}
+
+void Stats::setPeaks(const MemAccount::Check &c)
+{
+	for (int i = 0; i < MemAccount::TOTAL; i++)
+		peaks_[i] = c.peak(i);
+	peakTotal_ = c.peakTotal();
+	peaksSet_ = true;
+}
+
+Stats::Timer::Timer(int phase, Stats &s) : stats_(s)
+{
+	phase_ = phase;
+	if (enabled_) {
+		start_ = now();
+		bytes_ = memBytesAllocated;
+	}
+}
+
+Stats::Timer::~Timer()
+{
+	if (enabled_) {
+		stats_.times_[phase_] += now() - start_;
+		stats_.counters_[BYTES_ALLOCATED] += memBytesAllocated - bytes_;
+	}
+}
+
+/*	Write a string as a JSON string literal
+*/
+static void jsonString(String &dest, const String &s)
+{
+	dest << '"';
+	for (int i = 0; i < s.length(); i++) {
+		char c = s.charAt(i);
+		switch (c) {
+			case '"':
+			case '\\':
+				dest << '\\' << c;
+				break;
+			case '\n':
+				dest << "\\n";
+				break;
+			case '\t':
+				dest << "\\t";
+				break;
+			default:
+				if ((unsigned char)c < 0x20) {
+					// other control characters must be escaped too
+					char work[8];
+					sprintf(work, "\\u%04x", (unsigned char)c);
+					dest << work;
+				} else
+					dest << c;
+				break;
+		}
+	}
+	dest << '"';
+}
+
+void Stats::report(const char *kind, const String &text, const char *result)
+{
+	if (!enabled_) return;
+
+	Stats &s = current();
+
+	String t(text);
+	t.trimWS();
+
+	String r;
+	r << "{\"kind\":\"" << kind << "\",\"text\":";
+	jsonString(r, t);
+	r << ",\"result\":\"" << result << "\",\"ms\":{";
+	for (int i = 0; i < PHASES; i++) {
+		char work[30];
+		sprintf(work, "%.3f", s.times_[i] * 1000);
+		if (i > 0) r << ',';
+		r << '"' << phaseNames[i] << "\":" << work;
+	}
+	r << "},\"counters\":{";
+	for (int i = 0; i < COUNTERS; i++) {
+		char work[30];
+		sprintf(work, "%lld", s.counters_[i]);
+		if (i > 0) r << ',';
+		r << '"' << counterNames[i] << "\":" << work;
+	}
+	// the peaks recorded with the statistics, or else those of the
+	// current check, if any (otherwise, those of the process)
+	MemAccount::Check *c = MemAccount::check();
+	r << "},\"peak_kb\":{";
+	for (int i = 0; i < MemAccount::TOTAL; i++) {
+		long long peak = s.peaksSet_ ? s.peaks_[i]
+			: c ? c->peak(i) : MemAccount::peak(i);
+		if (i > 0) r << ',';
+		r << '"' << MemAccount::name(i) << "\":" << (int)(peak >> 10);
+	}
+	long long total = s.peaksSet_ ? s.peakTotal_
+		: c ? c->peakTotal() : MemAccount::peakTotal();
+	r << ",\"total\":" << (int)(total >> 10);
+	r << "}}\n";
+
+	Utils::getErrorSink() << r;
+	s.clear();
+	if (c != 0)
+		c->resetPeaks();
+	else
+		MemAccount::resetPeaks();
+}
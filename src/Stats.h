@@ -0,0 +1,152 @@
+#ifndef _STATS
+#define _STATS
+
+/*	Performance statistics
+
+	A Stats object accumulates counters, and the time spent in each
+	phase of checking.  The checkers add to the current one (see
+	current()); a thread that performs part of a check should
+	accumulate into its own object, which is added to the current one
+	by the thread that started it.  A thread can make its object the
+	current one by constructing a Stats::Use.
+
+	Collection is off until enable() is called.  While off, counting
+	does nothing but test a flag, and timers don't read the clock.
+*/
+class Stats {
+public:
+	enum {
+		// counters
+		MODEL_STATES,
+		MODEL_TRANS,
+		TABLEAU_NODES,
+		FORMULA_STATES,
+		FORMULA_TRANS,
+		PRODUCT_STATES,
+		PRODUCT_TRANS,
+		REDUCED_STATES,
+		REDUCED_TRANS,
+		DFS_STATES,
+		FIXPOINT_ITERS,
+		REACHABLE_STATES,
+		BYTES_ALLOCATED,
+		COUNTERS
+	};
+
+	enum {
+		// phases
+		PH_PARSE,
+		PH_TABLEAU,
+		PH_KRIPKE,
+		PH_PRODUCT,
+		PH_REDUCE,
+		PH_EMPTINESS,
+		PH_CTL,
+		PHASES
+	};
+
+	Stats() {clear();}
+
+	void clear();
+
+	/*	Add another object's counters and times to this one (and its
+			memory high-water marks, if it has any)
+	*/
+	void add(const Stats &s);
+
+	/*	Record the memory high-water marks of a check, to be reported
+			with these statistics instead of those of the current check;
+			used for checks made by other threads
+	*/
+	void setPeaks(const MemAccount::Check &c);
+
+	/*	Add to a counter
+			> counter					counter to add to
+			> n								amount to add
+	*/
+	void count(int counter, long long n = 1) {
+		if (enabled_)
+			counters_[counter] += n;
+	}
+
+	long long counter(int c) const {return counters_[c];}
+
+	/*	Get time spent in a phase, in seconds
+	*/
+	double time(int phase) const {return times_[phase];}
+
+	/*	Enable or disable collection
+	*/
+	static void enable(bool f = true) {enabled_ = f;}
+	static bool enabled() {return enabled_;}
+
+	/*	Get the object the checkers add to, on this thread
+	*/
+	static Stats &current() {
+		return current_ != 0 ? *current_ : default_;
+	}
+
+	/*	Makes an object current for this thread until destroyed
+	*/
+	class Use {
+	public:
+		Use(Stats &s) {
+			prev_ = current_;
+			current_ = &s;
+		}
+		~Use() {
+			current_ = prev_;
+		}
+	private:
+		Stats *prev_;
+	};
+
+	/*	If collection is enabled, write the current statistics, and
+			the high-water marks of each memory account (those recorded
+			with setPeaks(), or else those of the current check), to the
+			error sink as a JSON record (on a single line), then clear
+			them
+			> kind						type of record ("model", "ctl", "ltl", "compare")
+			> text						text of formula, or name of model
+			> result					result of check
+	*/
+	static void report(const char *kind, const String &text,
+		const char *result);
+
+	/*	Timer for a phase.  The time (and bytes allocated by this
+			thread) from construction to destruction are added to a
+			Stats object.
+	*/
+	class Timer {
+	public:
+		/*	Constructor
+				> phase						phase being timed
+				> s								object to add time to
+		*/
+		Timer(int phase, Stats &s = current());
+		~Timer();
+	private:
+		Stats &stats_;
+		int phase_;
+		double start_;
+		long long bytes_;
+	};
+
+private:
+	long long counters_[COUNTERS];
+	double times_[PHASES];
+	// memory high-water marks recorded by setPeaks(), for each
+	// account and in total, if peaksSet_ is true
+	long long peaks_[MemAccount::TOTAL];
+	long long peakTotal_;
+	bool peaksSet_;
+
+	static bool enabled_;
+	// object made current by a Use, or 0 for default_
+	static THREAD_LOCAL Stats *current_;
+	// object used by threads that haven't made one current; it's
+	// shared, so only one thread (e.g., the main one) should use it
+	static Stats default_;
+};
+
+#endif // _STATS
@@ -12,6 +12,8 @@ StringReader::StringReader(const String &s)
 void StringReader::construct() {
 	CONSTRUCT();
 	cursor_ = 0;
+	text_ = 0;
+	length_ = 0;
 	prevLen_ = -1;
 	prevPos_ = -1;
 	reading_ = false;
@@ -21,7 +23,7 @@ void StringReader::construct() {
 String StringReader::debInfo() {
 	String s("StringReader ");
 	s << "cursor=" << cursor_ << "\n";
-	String text(str_);
+	String text(text_, 0, length_);
 	text.replace(cursor_,0,">>>");
 	s << text.indent(5,"]");
 	return s;
@@ -73,21 +75,21 @@ Source& StringReader::operator >> (String &s)
 //	ASSERT(!eof());
 	s.clear();
 	int i = cursor_;
-	for (; i < str_.length(); i++) {
-		if (str_.charAt(i) == '\n') {
+	for (; i < length_; i++) {
+		if (text_[i] == '\n') {
 			i++;
 			break;
 		}
 	}
-	s.set(str_.subStr(cursor_,i-cursor_));
-	cursor_ = minVal(i, str_.length());
+	s.set(text_, cursor_, i-cursor_);
+	cursor_ = minVal(i, length_);
 	return *this;
 }
 
 bool StringReader::readWS() {
 	while (
 			!eof()
-			&& Utils::isWS( str_.charAt(cursor_))) {
+			&& Utils::isWS(text_[cursor_])) {
 		 cursor_++;
 		 }
 	return eof();
@@ -100,9 +102,9 @@ void StringReader::readWord(String &str) {
 	str.clear();
 
 	int i = 0;
-	while (cursor_ + i < str_.length() && !Utils::isWS(str_.charAt(cursor_ + i)))
+	while (cursor_ + i < length_ && !Utils::isWS(text_[cursor_ + i]))
 		i++;
-	str.set(str_.subStr(cursor_,i));
+	str.set(text_, cursor_, i);
 	cursor_ += i;
 	readWS();
 	updatePrevLen(str.length());
@@ -134,7 +136,7 @@ Source& StringReader::operator >> (short &i)
 Source& StringReader::operator >> (char &c)
 {
 	ASSERT(!eof());
-	c = str_.charAt(cursor_);
+	c = text_[cursor_];
 	cursor_++;
 	return *this;
 }
@@ -177,7 +179,7 @@ void StringReader::getLastItem(String &dest) const
 //	ASSERT(prevLen_ > 0);
 	dest.clear();
 	if (prevLen_ > 0)
-		dest.set(str_.subStr(prevPos_,prevLen_));
+		dest.set(text_, prevPos_, prevLen_);
 }
 
 void StringReader::extractWords(const String &s, StringArray &sa)
@@ -215,9 +217,16 @@ void StringReader::extractWords(const String &s, StringArray &sa)
 void StringReader::begin(const String &str, int startPos) {
 
 	str_ = str;
+	begin(str_.chars(), str_.length(), startPos);
+}
+
+void StringReader::begin(const char *chars, int len, int startPos) {
+
+	text_ = chars;
+	length_ = len;
 	cursor_ = startPos;
 	reading_ = true;
-	ASSERT(cursor_ >= 0 && cursor_ <= str_.length());
+	ASSERT(cursor_ >= 0 && cursor_ <= length_);
 
 //	readWS();
 }
@@ -226,7 +235,7 @@ char StringReader::readChar(bool mustExist) {
 	ASSERT(reading());
 	if (eof() && mustExist)
 		throw StringReaderException("Missing character");
-	return (eof() ? (char)0 : str_.charAt(cursor_++));
+	return (eof() ? (char)0 : text_[cursor_++]);
 }
 
 bool StringReader::readExpChar(char expected, bool mustFind) {
@@ -246,7 +255,7 @@ char StringReader::peekChar(int offset) const {
 	ASSERT(reading());
 
 	int i = cursor_ + offset;
-	char c = (i >= str_.length()) ? (char)0 : str_.charAt(i);
+	char c = (i >= length_) ? (char)0 : text_[i];
 	return c;
 }
 
@@ -270,7 +279,7 @@ int StringReader::readToken(DFA *dfa)
 	updatePrevPos();
 
 	if (dfa != 0) {
-		token = dfa->recognize(str_, cursor_, len);
+		token = dfa->recognize(text_, length_, cursor_, len);
 		move(len);
 		updatePrevLen(len);
 	}
@@ -282,7 +291,7 @@ int StringReader::readToken(DFA *dfa)
 
 void StringReader::move(int amt) {
 	ASSERT(reading());
-	ASSERT(cursor_ + amt >= 0 && cursor_ + amt <= str_.length());
+	ASSERT(cursor_ + amt >= 0 && cursor_ + amt <= length_);
 	cursor_ += amt;
 }
 
@@ -0,0 +1,53 @@
+#include "Headers.h"
+#include "Thread.h"
+
+void *Thread::entry(void *arg)
+{
+	Thread *t = (Thread *)arg;
+	try {
+		t->run();
+	} catch (Exception &e) {
+		t->failed_ = true;
+		t->error_.set(e.str());
+	}
+	return 0;
+}
+
+void Thread::start(int stackSize)
+{
+	ASSERT(!started_);
+	failed_ = false;
+	error_.clear();
+	started_ = true;
+
+#if UNIX
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	if (stackSize > 0)
+		pthread_attr_setstacksize(&attr, stackSize);
+	int err = pthread_create(&thread_, &attr, entry, this);
+	pthread_attr_destroy(&attr);
+	if (err != 0) {
+		// couldn't create thread; run it in this one instead
+		started_ = false;
+		entry(this);
+	}
+#else
+	started_ = false;
+	entry(this);
+#endif
+}
+
+void Thread::join()
+{
+#if UNIX
+	if (started_) {
+		pthread_join(thread_, 0);
+		started_ = false;
+	}
+#endif
+	if (failed_) {
+		failed_ = false;
+		throw Exception(error_);
+	}
+}
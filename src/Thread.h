@@ -0,0 +1,67 @@
+#ifndef _THREAD
+#define _THREAD
+
+#if UNIX
+#include <pthread.h>
+#endif
+
+/*	Thread of execution.  Subclasses implement run(), which
+		must not write to standard output; each thread has its own
+		active sink (Cout), so run() should push a string sink to
+		store its output, to be printed by the thread that calls join().
+
+		If threads are not supported on this platform, start()
+		calls run() directly.
+*/
+class Thread {
+public:
+	Thread() {
+		started_ = false;
+		failed_ = false;
+	}
+	/*	Destructor.  The thread should have been joined already
+			(before the subclass's members are destroyed); if it
+			wasn't, it's waited for here.  This doesn't throw, since
+			it may be called while unwinding from an exception.
+	*/
+	virtual ~Thread() {
+#if UNIX
+		if (started_)
+			pthread_join(thread_, 0);
+#endif
+	}
+
+	/*	Start executing run() in a new thread
+			> stackSize				size of stack, in bytes, or 0 for
+												the system default
+	*/
+	void start(int stackSize = 0);
+
+	/*	Wait for thread to finish.  If run() threw an exception,
+			it is rethrown here.
+	*/
+	void join();
+
+protected:
+	/*	Code to be executed by the thread
+	*/
+	virtual void run() = 0;
+
+private:
+	// no copying allowed
+	Thread(const Thread &s) {}
+	Thread& operator=(const Thread &s) {return *this;}
+
+	static void *entry(void *arg);
+
+	// message of exception thrown by run(), if any
+	String error_;
+	bool failed_;
+
+	bool started_;
+#if UNIX
+	pthread_t thread_;
+#endif
+};
+
+#endif // _THREAD
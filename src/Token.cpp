@@ -3,14 +3,54 @@
 #include "Token.h"
 #include "DFA.h"
 
-void Token::set(int type, int lineNum, int linePos, const String *srcStr,
-	int offset, int len
+void Token::set(int type, int lineNum, int linePos, const char *text,
+	int len, bool copy
 ) {
 	type_ = type;
 	lineNumber_ = lineNum;
 	linePos_ = linePos;
-	if (srcStr)
-		str_.set(srcStr->chars(),offset,len);
+	text_ = 0;
+	length_ = 0;
+	if (copy || text == 0) {
+		if (owned_ != 0 || text != 0)
+			own().set(text != 0 ? text : "", 0, len);
+	} else {
+		if (owned_ != 0) {
+			Delete(owned_);
+			owned_ = 0;
+		}
+		text_ = text;
+		length_ = len;
+	}
+}
+
+Token& Token::operator=(const Token &s)
+{
+	if (&s != this) {
+		type_ = s.type_;
+		lineNumber_ = s.lineNumber_;
+		linePos_ = s.linePos_;
+		text_ = s.text_;
+		length_ = s.length_;
+		if (s.owned_ != 0)
+			own().set(*s.owned_);
+		else if (owned_ != 0) {
+			Delete(owned_);
+			owned_ = 0;
+		}
+	}
+	return *this;
+}
+
+String &Token::own()
+{
+	if (owned_ == 0) {
+		New(owned_);
+		owned_->set(text_ != 0 ? text_ : "", 0, length_);
+		text_ = 0;
+		length_ = 0;
+	}
+	return *owned_;
 }
 
 Token::Token(int type, int lineNum,	int linePos) {
@@ -24,6 +64,9 @@ void Token::construct() {
 	type_ = T_EOF;
 	lineNumber_ = -1;
 	linePos_ = -1;
+	text_ = 0;
+	length_ = 0;
+	owned_ = 0;
 //	userData_ = -1;
 }
 
@@ -52,8 +95,11 @@ String Token::debInfo(const DFA *dfa) const {
 	s.pad(14);
 	if (lineNumber_ >= 0)
 		s << " (#" << fmt(lineNumber_,3) << ":" << fmt(linePos_,3) << ")";
-	if (str_.length())
-		s << " " << str_;
+	StrRef t = text();
+	if (t.length()) {
+		s << " ";
+		s.write(t.chars(), t.length());
+	}
 	return s;
 }
 #endif
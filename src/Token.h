@@ -12,13 +12,32 @@ public:
 												 for the start of the token, if lineNum >= 0
 	*/
 	Token(int type = T_EOF, int lineNum = -1, int linePos = -1);
+	~Token() {
+		if (owned_ != 0)
+			Delete(owned_);
+	}
+	Token(const Token &s) {
+		construct();
+		*this = s;
+	}
+	Token& operator=(const Token &s);
 private:
 	// initializer
 	void construct();
 	// --------------------------------
 public:
-	void set(int type, int lineNum=-1, int linePos=-1, const String *srcStr = 0,
-		int offset=0, int len=0);
+	/*	Set the token
+			> type						type of token (T_xxx)
+			> lineNum, linePos	as in constructor
+			> text						characters of token's text
+			> len							number of characters
+			> copy						if false, the token refers to the characters
+												 rather than copying them, and they must remain
+												 unchanged while the token (or a copy of it)
+												 uses them
+	*/
+	void set(int type, int lineNum=-1, int linePos=-1, const char *text = 0,
+		int len=0, bool copy = true);
 
 	//	Determine the type (T_xxx) of the token
 	int type() const { return type_; }
@@ -36,17 +55,54 @@ public:
 	String debInfo(const DFA *dfa = 0) const;
 #endif
 	void setStr(const String &s) {
-		str_ = s;
+		own().set(s);
+	}
+
+	/*	Get the string containing the token's text; if the token refers
+			to its text, it's copied to a string of its own
+	*/
+	String &str() {return own();}
+
+	/*	Get the token's text, without copying it
+	*/
+	StrRef text() const {
+		return owned_ != 0 ? StrRef(*owned_) : StrRef(text_, length_);
 	}
-	/*	Get the string containing the token's text
+
+	/*	Make the token independent of the text it was read from
+			> keepText				if true, copies the text; otherwise, discards it
 	*/
-	String &str() {return str_;}
+	void detach(bool keepText) {
+		if (keepText)
+			own();
+		else if (owned_ != 0)
+			owned_->clear();
+		text_ = 0;
+		length_ = 0;
+	}
+
+	void swap(Token &s) {
+		swapVal(type_, s.type_);
+		swapVal(lineNumber_, s.lineNumber_);
+		swapVal(linePos_, s.linePos_);
+		swapVal(text_, s.text_);
+		swapVal(length_, s.length_);
+		swapVal(owned_, s.owned_);
+	}
+	friend void moveValue(Token &dest, Token &src) {
+		dest.swap(src);
+	}
 
 	int lineNumber() const {return lineNumber_;}
 	int linePos() const {return linePos_;}
 //	int userData() const {return userData_;}
 //	void setUserData(int d) {userData_ = d;}
 private:
+	/*	Get the string owning the token's text, copying the text to it
+			if necessary
+	*/
+	String &own();
+
 	int type_;
 	// line number where token occurred (May not be a particular source
 	// line, but instead the line # this compile session.  This can be
@@ -54,8 +110,12 @@ private:
 	int lineNumber_;
 	// position in original (raw) source line for start of this token
 	int linePos_;
-	// text of token extracted from source
-	String str_;
+	// text of token, if it refers to characters it doesn't own
+	const char *text_;
+	int length_;
+	// text of token, if it owns it; 0 if it doesn't (the string is
+	// only allocated if needed, since most tokens are never stored)
+	String *owned_;
 	// application usage
 //	int userData_;
 };
@@ -9,44 +9,57 @@
 #include <windows.h>
 #endif
 
-class CoutSink : public Sink {
+// Each thread has its own active sink (0 for standard output), and
+// stack of sinks to restore, so threads can direct their output to
+// strings independently.
+static THREAD_LOCAL Sink *activeSink;
+
+enum {
+	SINK_STACK_SIZE = 40
+};
+static THREAD_LOCAL Sink *sinkStack[SINK_STACK_SIZE];
+static THREAD_LOCAL int sinkDepth;
+
+class CoutSink : public BufferedSink {
 public:
+	CoutSink() : BufferedSink(stdout) {}
 	~CoutSink() {
 		if (this == activeSink)
 			activeSink = 0;
 	}
-	// sink interface:
-	virtual Sink& operator << (const char *s) {cout << s;		return *this;}
-	virtual Sink& operator << (const String &s) {cout << s.chars(); return *this;}
-	virtual Sink& operator << (int i) {cout << i; return *this;}
-	virtual Sink& operator << (short s) {cout << s; return *this;}
-	virtual Sink& operator << (char c) {cout << c; return *this;}
-	virtual Sink& operator << (double d){cout << d; return *this;}
-	virtual Sink& operator << (float f){cout << f; return *this;}
 };
 
 
 CoutSink coutSink;
-Sink *activeSink = &coutSink;
-Stack<Sink *> streamStack;
 
-#define SYS_MEM_DISABLE true
 void Utils::pushSink(Sink *s) {
-	MEM_DISABLE(SYS_MEM_DISABLE);
-	streamStack.push(activeSink);
+	ASSERT(sinkDepth < SINK_STACK_SIZE);
+	sinkStack[sinkDepth++] = activeSink;
 	useSink(s);
-	MEM_RESTORE();
 }
 void Utils::popSink() {
-	MEM_DISABLE(SYS_MEM_DISABLE);
-	activeSink = streamStack.pop();
-	MEM_RESTORE();
+	ASSERT(sinkDepth > 0);
+	activeSink = sinkStack[--sinkDepth];
 }
 
 static OutputStreamWrapper *errWriter = 0;
+static Sink *errSink = 0;
+
+void Utils::useErrorSink(Sink *s) {
+	errSink = s;
+}
+
+void Utils::flushOutput()
+{
+	coutSink.flush();
+}
 
 Sink &Utils::getErrorSink()
 {
+	if (errSink != 0)
+		return *errSink;
+	// keep standard output and standard error in order
+	flushOutput();
 	if (errWriter == 0) {
 		errWriter = new OutputStreamWrapper(std::cerr);
 	}
@@ -79,31 +92,34 @@ void Utils::showMsg(const char *s) {
 #endif
 }
 
-void Utils::intToStr(int val, char *dest)
+int Utils::intToStr(int val, char *dest)
 {
+	char *start = dest;
+	unsigned int v = val;
 	if (val < 0) {
-		val = -val;
+		v = -v;
 		*dest++ = '-';
 	}
-	bool leadZero = true;
-
-	static int powers[] = {
-		1,10,100,1000,10000,100000,
-		1000000,10000000,100000000,1000000000 };
-
-	int i = 9;
-	while (i > 0 && powers[i] > val) i--;
 
+	// generate digits in reverse order, then copy them
+	char work[12];
+	int n = 0;
 	do {
-		int power = powers[i];
-		int d = abs(val / power);
-		if (!(leadZero && d == 0) || !i) {
-			leadZero = false;
-			*dest++ = '0' + (char)d;
-			val -= d * power;
-		}
-	} while (i--);
+		work[n++] = (char)('0' + v % 10);
+		v /= 10;
+	} while (v != 0);
+	while (n > 0)
+		*dest++ = work[--n];
 	*dest = 0;
+	return dest - start;
+}
+
+void Utils::printField(int val, int width)
+{
+	char work[12];
+	int len = intToStr(val, work);
+	pad(width - len);
+	Cout.write(work, len);
 }
 
 void Utils::intToBinary(int val, int digits, String &dest, const char *syms)
@@ -468,6 +484,20 @@ int Utils::parseInt(const char *s)
 #endif
 }
 
+int Utils::parseInt(const StrRef &s)
+{
+	// copy to a terminated buffer; on the stack, unless it's too long
+	char buff[32];
+	if (s.length() >= (int)sizeof(buff)) {
+		String str;
+		str.set(s.chars(), 0, s.length());
+		return parseInt(str);
+	}
+	memcpy(buff, s.chars(), s.length());
+	buff[s.length()] = 0;
+	return parseInt(buff);
+}
+
 /*	Calculate the modulus of a number; never returns a negative value
 		> val					value to take mod of
 		> divisor			amount to divide by
@@ -532,6 +562,36 @@ int Utils::hashFunction(const char *key)
 	return (int)(h & ~0x80000000);
 }
 
+/*	Calculate hash value for a sequence of bytes (FNV-1a, with the
+		result mixed so that all bits depend on every input byte)
+	> s				bytes
+	> len			number of bytes
+	< hash value
+*/
+unsigned Utils::hashBytes(const char *s, int len)
+{
+	unsigned h = 2166136261u;
+	for (int i = 0; i < len; i++) {
+		h ^= (unsigned char)s[i];
+		h *= 16777619u;
+	}
+	return hashInt(h);
+}
+
+/*	Calculate hash value for an integer (the MurmurHash3 finalizer)
+	> v				value
+	< hash value
+*/
+unsigned Utils::hashInt(unsigned v)
+{
+	v ^= v >> 16;
+	v *= 0x85ebca6bu;
+	v ^= v >> 13;
+	v *= 0xc2b2ae35u;
+	v ^= v >> 16;
+	return v;
+}
+
 bool Utils::isNumeric(char c)
 {
 	return (c >= '0' && c <= '9');
@@ -693,8 +753,13 @@ int Utils::rand(int mod)
 
 void Utils::pad(int len, char c)
 {
-	for (int i = 0; i < len; i++)
-		Cout << c;
+	char work[32];
+	memset(work, c, sizeof(work));
+	while (len > 0) {
+		int n = minVal(len, (int)sizeof(work));
+		Cout.write(work, n);
+		len -= n;
+	}
 }
 
 #if DEBUG
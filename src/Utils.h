@@ -23,7 +23,15 @@ public:
 	static void popSink();
 	static Sink &getActiveSink();
 	static Sink &getErrorSink();
+
+	/*	Send any output buffered for standard output to it
+	*/
+	static void flushOutput();
 	static void useSink(Sink *s);
+	/*	Redirect error output
+			> s								sink to send errors to, or 0 for standard error
+	*/
+	static void useErrorSink(Sink *s);
 	static void printIntArray(const Array<int> &a, const char *title = 0);
 	static void printInt(const int &i);
 	static const char *intArrayStr(const Array<int> &a, const char *title = 0);
@@ -72,6 +80,7 @@ public:
 
 	static int parseInt(const char *s);
 	static int parseInt(const String &s) { return parseInt(s.chars());}
+	static int parseInt(const StrRef &s);
 	static double parseDouble(const char *s);
 	static double parseDouble(const String &s) { return parseDouble(s.chars());}
 	static void parseString(const String &s, String &out) {
@@ -79,6 +88,8 @@ public:
 	static void parseString(const char *s, String &out);
 	static int mod(int val, int divisor);
 	static int hashFunction(const char *key);
+	static unsigned hashBytes(const char *s, int len);
+	static unsigned hashInt(unsigned v);
 	static bool isAlphaNumeric(char c, bool startOfWord = false, 
 		bool allowUnderscoreAtStart = true);
 	static bool isAlpha(char c, bool allowUnderscore = false);
@@ -88,7 +99,19 @@ public:
 	static bool isNumeric(char c);
 	static bool isLegal(char c);
 	static bool isWS(char c);
-	static void intToStr(int val, char *dest);
+	/*	Convert an integer to a zero-terminated string
+			> val							value
+			> dest						where to store the string; must have room for 12
+													characters
+			< length of string
+	*/
+	static int intToStr(int val, char *dest);
+
+	/*	Print an integer, right-justified in a field, to the active sink
+			> val							value
+			> width						width of field
+	*/
+	static void printField(int val, int width);
 	static void getScreenSize(int &x, int &y, int &w, int &h);
 	static void showMsg(const char *s);
 	static void showMsg(const String &s) {showMsg(s.chars()); }
@@ -3,30 +3,22 @@
 #undef pt
 #define pt(a) //pr(a)
 
-#if DOS
-#pragma warning(disable : 4311)
-#pragma warning(disable : 4312)
-#endif
 
-Vars *Vars::globalPtr_;
-
-int Vars::var(String &str, bool addIfMissing)
+int Vars::var(const StrRef &str, bool addIfMissing)
 {
-	pt(("Vars::var %s (add=%s)\n",str.s(),bs(addIfMissing) ));
+	pt(("Vars::var %.*s (add=%s)\n",str.length(),str.chars(),
+		bs(addIfMissing) ));
 
 	int index = -1;
-	void *ptr = tbl_.get(str);
-	pt((" hash table ptr is %p\n",ptr));
-	index = (*((int*)(&ptr)))-1;
-//	index = ((int) ptr) - 1;
-	pt((" cast to int %d\n",index));
-	if (index < 0) {
-		if (addIfMissing) {
-//			size_++;
-			index = strs_.length();
-			tbl_.set(str,(void *)(index+1));
-			strs_.add(str);
-		}
+	int *ptr = tbl_.find(str);
+	if (ptr != 0)
+		index = *ptr;
+	else if (addIfMissing) {
+		index = strs_.length();
+		String s;
+		s.set(str.chars(), 0, str.length());
+		tbl_.set(s, index);
+		strs_.addMove(s);
 	}
 	pt((" returning %d\n",index));
 	return index;
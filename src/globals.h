@@ -6,14 +6,23 @@
 #include "OrdSet.h"
 #include "BitStore.h"
 #include "SArray.h"
+#include "Arena.h"
 #include "HashTable.h"
+#include "HashMap.h"
+#include "Stats.h"
 #include "Vars.h"
 #include "Model.h"
 #include "Formula.h"
 #include "Forest.h"
+#include "Context.h"
 #include "CTLCheck.h"
+#include "Literals.h"
 #include "Buchi.h"
+#include "Thread.h"
 #include "LTLCheck.h"
+#include "Session.h"
+#include "Server.h"
+#include "Checker.h"
 
 enum {
 	TK_WS,
@@ -50,6 +59,7 @@ enum {
 	TK_AX,
 	TK_EX,
 	// end sequence
+	TK_DELTAOP,
 	TK_TOTAL,
 };
 